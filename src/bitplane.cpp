@@ -0,0 +1,378 @@
+#include "bitplane.h"
+#include "simd.h"
+#include <algorithm>
+#include <bit>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    size_t words_for(int bits) {
+        return (static_cast<size_t>(bits) + 63) / 64;
+    }
+
+    int normalize(int offset, int n) {
+        return (n == 0) ? 0 : ((offset % n) + n) % n;
+    }
+}
+
+aoc::bits::plane::plane(int wd, int hgt) :
+    wd_(wd),
+    hgt_(hgt),
+    stride_(words_for(wd)),
+    words_(stride_ * hgt, 0)
+{}
+
+void aoc::bits::plane::clear_padding() {
+    auto extra = wd_ % 64;
+    if (extra == 0) {
+        return;
+    }
+    auto mask = (static_cast<uint64_t>(1) << extra) - 1;
+    for (int y = 0; y < hgt_; ++y) {
+        row(y)[stride_ - 1] &= mask;
+    }
+}
+
+int aoc::bits::plane::width() const {
+    return wd_;
+}
+
+int aoc::bits::plane::height() const {
+    return hgt_;
+}
+
+size_t aoc::bits::plane::stride() const {
+    return stride_;
+}
+
+bool aoc::bits::plane::test(int x, int y) const {
+    if (x < 0 || x >= wd_ || y < 0 || y >= hgt_) {
+        return false;
+    }
+    return (row(y)[x / 64] >> (x % 64)) & 1;
+}
+
+void aoc::bits::plane::set(int x, int y, bool val) {
+    auto& word = row(y)[x / 64];
+    auto bit = static_cast<uint64_t>(1) << (x % 64);
+    word = val ? (word | bit) : (word & ~bit);
+}
+
+void aoc::bits::plane::clear() {
+    std::fill(words_.begin(), words_.end(), 0);
+}
+
+uint64_t* aoc::bits::plane::row(int y) {
+    return words_.data() + y * stride_;
+}
+
+const uint64_t* aoc::bits::plane::row(int y) const {
+    return words_.data() + y * stride_;
+}
+
+std::vector<uint64_t>& aoc::bits::plane::words() {
+    return words_;
+}
+
+const std::vector<uint64_t>& aoc::bits::plane::words() const {
+    return words_;
+}
+
+size_t aoc::bits::plane::count() const {
+    return static_cast<size_t>(aoc::simd::popcount(words_.data(), words_.size()));
+}
+
+bool aoc::bits::plane::any() const {
+    return std::any_of(words_.begin(), words_.end(), [](uint64_t w) {return w != 0; });
+}
+
+std::optional<std::tuple<int, int, int, int>> aoc::bits::plane::bounds() const {
+    int y1 = -1;
+    int y2 = -1;
+    std::vector<uint64_t> columns(stride_, 0);
+    for (int y = 0; y < hgt_; ++y) {
+        auto words = row(y);
+        bool occupied = false;
+        for (size_t i = 0; i < stride_; ++i) {
+            columns[i] |= words[i];
+            occupied = occupied || words[i];
+        }
+        if (occupied) {
+            y1 = (y1 < 0) ? y : y1;
+            y2 = y;
+        }
+    }
+    if (y1 < 0) {
+        return {};
+    }
+    int x1 = -1;
+    int x2 = -1;
+    for (size_t i = 0; i < stride_; ++i) {
+        if (columns[i]) {
+            auto base = static_cast<int>(64 * i);
+            x1 = (x1 < 0) ? base + std::countr_zero(columns[i]) : x1;
+            x2 = base + static_cast<int>(std::bit_width(columns[i])) - 1;
+        }
+    }
+    return { { x1, y1, x2, y2 } };
+}
+
+aoc::bits::plane& aoc::bits::plane::operator|=(const plane& rhs) {
+    for (size_t i = 0; i < words_.size(); ++i) {
+        words_[i] |= rhs.words_[i];
+    }
+    return *this;
+}
+
+aoc::bits::plane& aoc::bits::plane::operator&=(const plane& rhs) {
+    for (size_t i = 0; i < words_.size(); ++i) {
+        words_[i] &= rhs.words_[i];
+    }
+    return *this;
+}
+
+aoc::bits::plane& aoc::bits::plane::operator^=(const plane& rhs) {
+    for (size_t i = 0; i < words_.size(); ++i) {
+        words_[i] ^= rhs.words_[i];
+    }
+    return *this;
+}
+
+aoc::bits::plane& aoc::bits::plane::and_not(const plane& rhs) {
+    for (size_t i = 0; i < words_.size(); ++i) {
+        words_[i] &= ~rhs.words_[i];
+    }
+    return *this;
+}
+
+aoc::bits::plane aoc::bits::plane::operator~() const {
+    plane out = *this;
+    for (auto& word : out.words_) {
+        word = ~word;
+    }
+    out.clear_padding();
+    return out;
+}
+
+bool aoc::bits::plane::operator==(const plane& rhs) const {
+    return wd_ == rhs.wd_ && hgt_ == rhs.hgt_ && words_ == rhs.words_;
+}
+
+aoc::bits::plane aoc::bits::plane::shifted(int dx, int dy) const {
+    plane out(wd_, hgt_);
+    for (int y = 0; y < hgt_; ++y) {
+        int src_y = y - dy;
+        if (src_y < 0 || src_y >= hgt_) {
+            continue;
+        }
+        auto dst = out.row(y);
+        std::copy(row(src_y), row(src_y) + stride_, dst);
+        if (dx > 0) {
+            aoc::simd::shift_left(dst, stride_, dx);
+        } else if (dx < 0) {
+            aoc::simd::shift_right(dst, stride_, -dx);
+        }
+    }
+    if (dx > 0) {
+        out.clear_padding();
+    }
+    return out;
+}
+
+aoc::bits::plane aoc::bits::plane::rotated(int dx, int dy) const {
+    dx = normalize(dx, wd_);
+    dy = normalize(dy, hgt_);
+    plane out(wd_, hgt_);
+    std::vector<uint64_t> wrapped(stride_);
+    for (int y = 0; y < hgt_; ++y) {
+        auto src = row((y + hgt_ - dy) % hgt_);
+        auto dst = out.row(y);
+        std::copy(src, src + stride_, dst);
+        if (dx == 0) {
+            continue;
+        }
+        std::copy(src, src + stride_, wrapped.begin());
+        aoc::simd::shift_left(dst, stride_, dx);
+        aoc::simd::shift_right(wrapped.data(), stride_, wd_ - dx);
+        for (size_t i = 0; i < stride_; ++i) {
+            dst[i] |= wrapped[i];
+        }
+    }
+    out.clear_padding();
+    return out;
+}
+
+aoc::bits::plane aoc::bits::plane::dilated(neighborhood nbhd) const {
+    auto horz = *this | shifted(1, 0) | shifted(-1, 0);
+    if (nbhd == neighborhood::moore) {
+        return horz | horz.shifted(0, 1) | horz.shifted(0, -1);
+    }
+    return horz | shifted(0, 1) | shifted(0, -1);
+}
+
+aoc::bits::plane aoc::bits::plane::extended(int margin) const {
+    plane out(wd_ + 2 * margin, hgt_ + 2 * margin);
+    for (int y = 0; y < hgt_; ++y) {
+        auto dst = out.row(y + margin);
+        std::copy(row(y), row(y) + stride_, dst);
+        aoc::simd::shift_left(dst, out.stride_, margin);
+    }
+    return out;
+}
+
+aoc::bits::plane aoc::bits::operator|(plane lhs, const plane& rhs) {
+    return lhs |= rhs;
+}
+
+aoc::bits::plane aoc::bits::operator&(plane lhs, const plane& rhs) {
+    return lhs &= rhs;
+}
+
+aoc::bits::plane aoc::bits::operator^(plane lhs, const plane& rhs) {
+    return lhs ^= rhs;
+}
+
+aoc::bits::plane aoc::bits::and_not(plane lhs, const plane& rhs) {
+    return lhs.and_not(rhs);
+}
+
+aoc::bits::plane aoc::bits::flood_fill(const plane& seed, const plane& open, neighborhood nbhd) {
+    auto filled = seed & open;
+    while (true) {
+        auto next = filled.dilated(nbhd) & open;
+        if (next == filled) {
+            return filled;
+        }
+        filled = std::move(next);
+    }
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+aoc::bits::volume::volume(int wd, int hgt, int dep) :
+    wd_(wd),
+    hgt_(hgt),
+    dep_(dep),
+    layers_(dep, plane(wd, hgt))
+{}
+
+int aoc::bits::volume::width() const {
+    return wd_;
+}
+
+int aoc::bits::volume::height() const {
+    return hgt_;
+}
+
+int aoc::bits::volume::depth() const {
+    return dep_;
+}
+
+bool aoc::bits::volume::test(int x, int y, int z) const {
+    if (z < 0 || z >= dep_) {
+        return false;
+    }
+    return layers_[z].test(x, y);
+}
+
+void aoc::bits::volume::set(int x, int y, int z, bool val) {
+    layers_[z].set(x, y, val);
+}
+
+aoc::bits::plane& aoc::bits::volume::layer(int z) {
+    return layers_[z];
+}
+
+const aoc::bits::plane& aoc::bits::volume::layer(int z) const {
+    return layers_[z];
+}
+
+size_t aoc::bits::volume::count() const {
+    size_t n = 0;
+    for (const auto& layer : layers_) {
+        n += layer.count();
+    }
+    return n;
+}
+
+aoc::bits::volume& aoc::bits::volume::operator|=(const volume& rhs) {
+    for (int z = 0; z < dep_; ++z) {
+        layers_[z] |= rhs.layers_[z];
+    }
+    return *this;
+}
+
+aoc::bits::volume& aoc::bits::volume::operator&=(const volume& rhs) {
+    for (int z = 0; z < dep_; ++z) {
+        layers_[z] &= rhs.layers_[z];
+    }
+    return *this;
+}
+
+aoc::bits::volume& aoc::bits::volume::and_not(const volume& rhs) {
+    for (int z = 0; z < dep_; ++z) {
+        layers_[z].and_not(rhs.layers_[z]);
+    }
+    return *this;
+}
+
+aoc::bits::volume aoc::bits::volume::operator~() const {
+    volume out = *this;
+    for (auto& layer : out.layers_) {
+        layer = ~layer;
+    }
+    return out;
+}
+
+bool aoc::bits::volume::operator==(const volume& rhs) const {
+    return layers_ == rhs.layers_;
+}
+
+aoc::bits::volume aoc::bits::volume::shifted(int dx, int dy, int dz) const {
+    volume out(wd_, hgt_, dep_);
+    for (int z = 0; z < dep_; ++z) {
+        int src_z = z - dz;
+        if (src_z >= 0 && src_z < dep_) {
+            out.layers_[z] = layers_[src_z].shifted(dx, dy);
+        }
+    }
+    return out;
+}
+
+aoc::bits::volume aoc::bits::volume::dilated() const {
+    volume out(wd_, hgt_, dep_);
+    for (int z = 0; z < dep_; ++z) {
+        out.layers_[z] = layers_[z].dilated();
+        if (z > 0) {
+            out.layers_[z] |= layers_[z - 1];
+        }
+        if (z + 1 < dep_) {
+            out.layers_[z] |= layers_[z + 1];
+        }
+    }
+    return out;
+}
+
+aoc::bits::volume aoc::bits::operator|(volume lhs, const volume& rhs) {
+    return lhs |= rhs;
+}
+
+aoc::bits::volume aoc::bits::operator&(volume lhs, const volume& rhs) {
+    return lhs &= rhs;
+}
+
+aoc::bits::volume aoc::bits::and_not(volume lhs, const volume& rhs) {
+    return lhs.and_not(rhs);
+}
+
+aoc::bits::volume aoc::bits::flood_fill(const volume& seed, const volume& open) {
+    auto filled = seed & open;
+    while (true) {
+        auto next = filled.dilated() & open;
+        if (next == filled) {
+            return filled;
+        }
+        filled = std::move(next);
+    }
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+/*------------------------------------------------------------------------------------------------*/
+
+// bit-plane grids for the cellular-automaton style days. a plane stores one bit per cell, row
+// by row, each row padded to a whole number of 64-bit words with cell x at bit x of the row;
+// a volume is a stack of planes. update rules are written as whole-plane shifts and boolean
+// operations instead of per-cell lookups; row shifts and counts go through the simd layer.
+// cells outside a plane read as clear, and anything shifted off an edge is dropped.
+
+namespace aoc::bits {
+
+    enum class neighborhood {
+        von_neumann, // the four orthogonal neighbours
+        moore        // all eight neighbours
+    };
+
+    class plane {
+        int wd_;
+        int hgt_;
+        size_t stride_;
+        std::vector<uint64_t> words_;
+
+        void clear_padding();
+
+    public:
+        plane(int wd = 0, int hgt = 0);
+
+        int width() const;
+        int height() const;
+        size_t stride() const; // words per row
+
+        bool test(int x, int y) const;
+        void set(int x, int y, bool val = true);
+        void clear();
+
+        uint64_t* row(int y);
+        const uint64_t* row(int y) const;
+        std::vector<uint64_t>& words();
+        const std::vector<uint64_t>& words() const;
+
+        size_t count() const;
+        bool any() const;
+
+        // (x1, y1, x2, y2) of the set cells, inclusive; nothing if the plane is empty
+        std::optional<std::tuple<int, int, int, int>> bounds() const;
+
+        plane& operator|=(const plane& rhs);
+        plane& operator&=(const plane& rhs);
+        plane& operator^=(const plane& rhs);
+        plane& and_not(const plane& rhs); // this &= ~rhs
+        plane operator~() const;
+        bool operator==(const plane& rhs) const;
+
+        // the contents moved by (dx, dy): the result at (x, y) is this at (x - dx, y - dy)
+        plane shifted(int dx, int dy) const;
+
+        // as shifted, but cells leaving one edge re-enter at the opposite edge
+        plane rotated(int dx, int dy) const;
+
+        // every set cell together with its neighbours
+        plane dilated(neighborhood nbhd = neighborhood::von_neumann) const;
+
+        // the same contents in a plane that is larger by margin cells on every side
+        plane extended(int margin) const;
+    };
+
+    plane operator|(plane lhs, const plane& rhs);
+    plane operator&(plane lhs, const plane& rhs);
+    plane operator^(plane lhs, const plane& rhs);
+    plane and_not(plane lhs, const plane& rhs);
+
+    // the cells connected to seed through open cells, seed included where it is open
+    plane flood_fill(const plane& seed, const plane& open,
+        neighborhood nbhd = neighborhood::von_neumann);
+
+    class volume {
+        int wd_;
+        int hgt_;
+        int dep_;
+        std::vector<plane> layers_;
+
+    public:
+        volume(int wd = 0, int hgt = 0, int dep = 0);
+
+        int width() const;
+        int height() const;
+        int depth() const;
+
+        bool test(int x, int y, int z) const;
+        void set(int x, int y, int z, bool val = true);
+
+        plane& layer(int z);
+        const plane& layer(int z) const;
+
+        size_t count() const;
+
+        volume& operator|=(const volume& rhs);
+        volume& operator&=(const volume& rhs);
+        volume& and_not(const volume& rhs);
+        volume operator~() const;
+        bool operator==(const volume& rhs) const;
+
+        volume shifted(int dx, int dy, int dz) const;
+
+        // every set cell together with its six face neighbours
+        volume dilated() const;
+    };
+
+    volume operator|(volume lhs, const volume& rhs);
+    volume operator&(volume lhs, const volume& rhs);
+    volume and_not(volume lhs, const volume& rhs);
+
+    volume flood_fill(const volume& seed, const volume& open);
+}
@@ -0,0 +1,140 @@
+#include "cache.h"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace fs = std::filesystem;
+
+namespace {
+
+    constexpr uint64_t k_magic = 0x314b52414f434f41ull; // "AOCOARK1"
+
+    struct artifact_header {
+        uint64_t magic;
+        uint64_t input_hash;
+        uint64_t payload_size;
+        uint32_t version;
+        uint32_t reserved;
+    };
+
+    std::optional<fs::path> cache_dir() {
+        const char* dir = std::getenv("AOC_CACHE_DIR");
+        if (!dir || !*dir) {
+            return {};
+        }
+        return fs::path(dir);
+    }
+
+    fs::path artifact_path(const fs::path& dir, const aoc::cache::artifact_id& id) {
+        std::stringstream ss;
+        ss << id.name << "-v" << id.version << "-" <<
+            std::hex << std::setw(16) << std::setfill('0') << id.input_hash << ".bin";
+        return dir / ss.str();
+    }
+}
+
+// FNV-1a
+uint64_t aoc::cache::hash_bytes(const void* data, size_t n, uint64_t seed) {
+    auto bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < n; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+uint64_t aoc::cache::hash_string(const std::string& str) {
+    return hash_bytes(str.data(), str.size());
+}
+
+uint64_t aoc::cache::hash_lines(const std::vector<std::string>& lines) {
+    uint64_t hash = hash_bytes(nullptr, 0);
+    for (const auto& line : lines) {
+        hash = hash_bytes(line.data(), line.size(), hash);
+        hash = hash_bytes("\n", 1, hash);
+    }
+    return hash;
+}
+
+bool aoc::cache::enabled() {
+    return cache_dir().has_value();
+}
+
+std::optional<aoc::cache::mapped_file> aoc::cache::open_artifact(
+        const artifact_id& id, blob_reader& payload) {
+    auto dir = cache_dir();
+    if (!dir) {
+        return {};
+    }
+    return open_artifact(dir->string(), id, payload);
+}
+
+void aoc::cache::store_artifact(const artifact_id& id, const blob_writer& payload) {
+    auto dir = cache_dir();
+    if (!dir) {
+        return;
+    }
+    store_artifact(dir->string(), id, payload);
+}
+
+std::optional<aoc::cache::mapped_file> aoc::cache::open_artifact(
+        const std::string& dir, const artifact_id& id, blob_reader& payload) {
+    auto path = artifact_path(dir, id);
+    std::error_code ec;
+    if (!fs::exists(path, ec)) {
+        return {};
+    }
+    try {
+        mapped_file file(path.string());
+        artifact_header header;
+        if (file.size() < sizeof(header)) {
+            return {};
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (header.magic != k_magic || header.version != id.version ||
+                header.input_hash != id.input_hash ||
+                header.payload_size != file.size() - sizeof(header)) {
+            return {};
+        }
+        payload = blob_reader(file.data() + sizeof(header), header.payload_size);
+        return file;
+    } catch (const std::runtime_error&) {
+        return {};
+    }
+}
+
+void aoc::cache::store_artifact(
+        const std::string& dir, const artifact_id& id, const blob_writer& payload) {
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+
+    // write to a temporary name and rename so a concurrent reader never sees a partial file
+    auto path = artifact_path(dir, id);
+    auto tmp_path = path;
+    tmp_path += ".tmp";
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return;
+        }
+        artifact_header header = {
+            k_magic, id.input_hash, static_cast<uint64_t>(payload.bytes().size()), id.version, 0
+        };
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(payload.bytes().data(), static_cast<std::streamsize>(payload.bytes().size()));
+        if (!out) {
+            return;
+        }
+    }
+    fs::rename(tmp_path, path, ec);
+}
+
+void aoc::cache::remove_artifact(const std::string& dir, const artifact_id& id) {
+    std::error_code ec;
+    fs::remove(artifact_path(dir, id), ec);
+}
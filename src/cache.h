@@ -0,0 +1,146 @@
+#pragma once
+
+#include "util.h"
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/*------------------------------------------------------------------------------------------------*/
+
+// an opt-in disk cache for derived structures that cost more to build than to use. it is
+// enabled by setting the environment variable AOC_CACHE_DIR to a directory; artifacts are
+// keyed by name, a version number that must be bumped whenever the layout or the algorithm
+// that builds them changes, and a hash of the input they were built from. cached files are
+// memory-mapped when read back.
+
+namespace aoc::cache {
+
+    struct artifact_id {
+        std::string name;
+        uint32_t version;
+        uint64_t input_hash;
+    };
+
+    uint64_t hash_bytes(const void* data, size_t n, uint64_t seed = 0xcbf29ce484222325ull);
+    uint64_t hash_lines(const std::vector<std::string>& lines);
+    uint64_t hash_string(const std::string& str);
+
+    class blob_writer {
+        std::vector<char> bytes_;
+    public:
+        template <typename T>
+        void write(const T& val) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            auto ptr = reinterpret_cast<const char*>(&val);
+            bytes_.insert(bytes_.end(), ptr, ptr + sizeof(T));
+        }
+
+        template <typename T>
+        void write_vector(const std::vector<T>& vec) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            write(static_cast<uint64_t>(vec.size()));
+            auto ptr = reinterpret_cast<const char*>(vec.data());
+            bytes_.insert(bytes_.end(), ptr, ptr + vec.size() * sizeof(T));
+        }
+
+        void write_string(const std::string& str) {
+            write(static_cast<uint64_t>(str.size()));
+            bytes_.insert(bytes_.end(), str.begin(), str.end());
+        }
+
+        const std::vector<char>& bytes() const {
+            return bytes_;
+        }
+    };
+
+    class blob_reader {
+        const char* ptr_;
+        const char* end_;
+
+        void require(size_t n) const {
+            if (static_cast<size_t>(end_ - ptr_) < n) {
+                throw std::runtime_error("truncated cache artifact");
+            }
+        }
+
+    public:
+        blob_reader(const char* data, size_t n) : ptr_(data), end_(data + n)
+        {}
+
+        size_t remaining() const {
+            return static_cast<size_t>(end_ - ptr_);
+        }
+
+        template <typename T>
+        T read() {
+            static_assert(std::is_trivially_copyable_v<T>);
+            require(sizeof(T));
+            T val;
+            std::memcpy(&val, ptr_, sizeof(T));
+            ptr_ += sizeof(T);
+            return val;
+        }
+
+        template <typename T>
+        std::vector<T> read_vector() {
+            static_assert(std::is_trivially_copyable_v<T>);
+            auto n = read<uint64_t>();
+            // checked by division, as a corrupt count could overflow n * sizeof(T)
+            if (n > static_cast<size_t>(end_ - ptr_) / sizeof(T)) {
+                throw std::runtime_error("truncated cache artifact");
+            }
+            std::vector<T> vec(n);
+            std::memcpy(vec.data(), ptr_, n * sizeof(T));
+            ptr_ += n * sizeof(T);
+            return vec;
+        }
+
+        std::string read_string() {
+            auto n = read<uint64_t>();
+            require(n);
+            std::string str(ptr_, ptr_ + n);
+            ptr_ += n;
+            return str;
+        }
+    };
+
+    // cached files are read back through the same read-only mapping that days use for input
+    using mapped_file = aoc::mapped_file;
+
+    bool enabled();
+
+    // the payload of a cached artifact, or nothing if it is absent, stale or unreadable.
+    std::optional<mapped_file> open_artifact(const artifact_id& id, blob_reader& payload);
+    void store_artifact(const artifact_id& id, const blob_writer& payload);
+
+    // the same in an explicit directory, for artifacts that live outside the cache
+    std::optional<mapped_file> open_artifact(const std::string& dir, const artifact_id& id,
+        blob_reader& payload);
+    void store_artifact(const std::string& dir, const artifact_id& id, const blob_writer& payload);
+    void remove_artifact(const std::string& dir, const artifact_id& id);
+
+    template <typename Build, typename Save, typename Load>
+    auto get_or_build(const artifact_id& id, Build build, Save save, Load load) -> decltype(build()) {
+        if (!enabled()) {
+            return build();
+        }
+        blob_reader payload(nullptr, 0);
+        if (auto file = open_artifact(id, payload)) {
+            try {
+                return load(payload);
+            } catch (const std::runtime_error&) {
+                // fall through and rebuild a damaged artifact
+            }
+        }
+        auto value = build();
+        blob_writer writer;
+        save(writer, value);
+        store_artifact(id, writer);
+        return value;
+    }
+}
@@ -0,0 +1,57 @@
+#include "checkpoint.h"
+#include <atomic>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+    std::string checkpoint_dir;
+    std::chrono::steady_clock::duration checkpoint_interval;
+    std::atomic<bool> checkpoint_enabled = false;
+    bool checkpoint_resume = false;
+}
+
+void aoc::checkpoint::configure(const std::string& dir, double interval_seconds, bool resume) {
+    checkpoint_dir = dir;
+    checkpoint_interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(interval_seconds)
+    );
+    checkpoint_resume = resume;
+    checkpoint_enabled = true;
+}
+
+bool aoc::checkpoint::enabled() {
+    return checkpoint_enabled.load(std::memory_order_relaxed);
+}
+
+bool aoc::checkpoint::resuming() {
+    return enabled() && checkpoint_resume;
+}
+
+aoc::checkpoint::snapshot::snapshot(const std::string& name, uint32_t version, uint64_t input_hash) :
+    id_{ name, version, input_hash },
+    next_save_(std::chrono::steady_clock::now() + checkpoint_interval)
+{}
+
+void aoc::checkpoint::snapshot::finish() {
+    if (enabled()) {
+        cache::remove_artifact(checkpoint_dir, id_);
+    }
+}
+
+std::optional<aoc::cache::mapped_file> aoc::checkpoint::snapshot::open(
+        cache::blob_reader& payload) const {
+    return cache::open_artifact(checkpoint_dir, id_, payload);
+}
+
+bool aoc::checkpoint::snapshot::due() {
+    auto now = std::chrono::steady_clock::now();
+    if (now < next_save_) {
+        return false;
+    }
+    next_save_ = now + checkpoint_interval;
+    return true;
+}
+
+void aoc::checkpoint::snapshot::store(const cache::blob_writer& payload) {
+    cache::store_artifact(checkpoint_dir, id_, payload);
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "cache.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/*------------------------------------------------------------------------------------------------*/
+
+// periodic snapshots of the long-running simulations, so that a run that is killed part way can
+// pick up where it left off. main turns this on with --checkpoint[=seconds], which saves each
+// simulation's state at most that often, and --resume, which also loads any saved state when a
+// simulation starts. snapshots use the disk cache's artifact format, are keyed by a name, a
+// layout version and a hash of the simulation's input, and are deleted once it completes.
+
+namespace aoc::checkpoint {
+
+    void configure(const std::string& dir, double interval_seconds, bool resume);
+    bool enabled();
+    bool resuming();
+
+    class snapshot {
+        cache::artifact_id id_;
+        std::chrono::steady_clock::time_point next_save_;
+
+    public:
+        snapshot(const std::string& name, uint32_t version, uint64_t input_hash);
+
+        // when resuming from a saved state, hands its payload to load and returns true. load may
+        // throw std::runtime_error on a damaged snapshot, which is then ignored.
+        template <typename Load>
+        bool restore(Load load) {
+            if (!resuming()) {
+                return false;
+            }
+            cache::blob_reader payload(nullptr, 0);
+            auto file = open(payload);
+            if (!file) {
+                return false;
+            }
+            try {
+                load(payload);
+                return true;
+            } catch (const std::runtime_error&) {
+                return false;
+            }
+        }
+
+        // calls save with a writer and stores the result if a snapshot is due; meant to be called
+        // once per step of a simulation, and only reads the clock when checkpointing is on.
+        template <typename Save>
+        void tick(Save save) {
+            if (!enabled() || !due()) {
+                return;
+            }
+            cache::blob_writer writer;
+            save(writer);
+            store(writer);
+        }
+
+        // the simulation has finished; drops its snapshot
+        void finish();
+
+    private:
+        std::optional<cache::mapped_file> open(cache::blob_reader& payload) const;
+        bool due();
+        void store(const cache::blob_writer& payload);
+    };
+}
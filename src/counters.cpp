@@ -0,0 +1,62 @@
+#include "counters.h"
+
+#ifdef AOC_ENABLE_COUNTERS
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+    struct registry {
+        std::mutex mutex;
+        std::vector<const aoc::counters::counter*> counters;
+        std::vector<std::pair<std::string, std::function<void(std::ostream&)>>> sections;
+    };
+
+    registry& counter_registry() {
+        static registry reg;
+        return reg;
+    }
+}
+
+aoc::counters::counter::counter(const char* name) :
+    name_(name),
+    value_(0) {
+    auto& reg = counter_registry();
+    std::lock_guard lock(reg.mutex);
+    reg.counters.push_back(this);
+}
+
+void aoc::counters::add_section(const std::string& title,
+        std::function<void(std::ostream&)> write) {
+    auto& reg = counter_registry();
+    std::lock_guard lock(reg.mutex);
+    reg.sections.emplace_back(title, std::move(write));
+}
+
+void aoc::counters::report(std::ostream& os) {
+    auto& reg = counter_registry();
+    std::lock_guard lock(reg.mutex);
+
+    // the same name used at several call sites is reported as one total
+    std::map<std::string, uint64_t> totals;
+    for (const auto* c : reg.counters) {
+        totals[c->name()] += c->value();
+    }
+    if (!totals.empty()) {
+        os << "\n  counters:\n";
+        for (const auto& [name, value] : totals) {
+            os << "    " << name << ": " << value << "\n";
+        }
+    }
+    for (const auto& [title, write] : reg.sections) {
+        os << "\n  " << title << ":\n";
+        write(os);
+    }
+}
+
+#endif
@@ -0,0 +1,60 @@
+#pragma once
+
+/*------------------------------------------------------------------------------------------------*/
+
+// hot-path event counters. they only exist when the project is built with AOC_ENABLE_COUNTERS
+// defined; otherwise AOC_COUNT(...) expands to nothing and costs nothing. when enabled, main
+// prints every counter that fired after the day finishes.
+//
+//     AOC_COUNT(states_expanded);
+//     AOC_COUNT_N(cells_scanned, row_width);
+
+#ifdef AOC_ENABLE_COUNTERS
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+
+namespace aoc::counters {
+
+    class counter {
+        const char* name_;
+        std::atomic<uint64_t> value_;
+    public:
+        counter(const char* name);
+
+        void add(uint64_t n) {
+            value_.fetch_add(n, std::memory_order_relaxed);
+        }
+
+        const char* name() const {
+            return name_;
+        }
+
+        uint64_t value() const {
+            return value_.load(std::memory_order_relaxed);
+        }
+    };
+
+    // a titled block of output that report prints after the counters, for instrumentation
+    // that is more than a count, e.g. per-rule parser statistics
+    void add_section(const std::string& title, std::function<void(std::ostream&)> write);
+
+    void report(std::ostream& os);
+}
+
+#define AOC_COUNT_N(name, n) \
+    do { \
+        static aoc::counters::counter aoc_counter_##name(#name); \
+        aoc_counter_##name.add(static_cast<uint64_t>(n)); \
+    } while (false)
+
+#else
+
+#define AOC_COUNT_N(name, n) do {} while (false)
+
+#endif
+
+#define AOC_COUNT(name) AOC_COUNT_N(name, 1)
@@ -0,0 +1,176 @@
+#include "csr_graph.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+/*------------------------------------------------------------------------------------------------*/
+
+aoc::csr::graph::graph(int num_vertices, const std::vector<edge>& edges) :
+    offsets_(num_vertices + 1, 0),
+    targets_(edges.size()),
+    weights_(edges.size())
+{
+    // a counting sort of the edges by source that keeps the given order within a source
+    for (const auto& e : edges) {
+        if (e.from < 0 || e.from >= num_vertices || e.to < 0 || e.to >= num_vertices) {
+            throw std::runtime_error("csr::graph: edge out of range");
+        }
+        ++offsets_[e.from + 1];
+    }
+    for (int u = 0; u < num_vertices; ++u) {
+        offsets_[u + 1] += offsets_[u];
+    }
+    std::vector<int> next(offsets_.begin(), offsets_.end() - 1);
+    for (const auto& e : edges) {
+        auto slot = next[e.from]++;
+        targets_[slot] = e.to;
+        weights_[slot] = e.weight;
+    }
+}
+
+aoc::csr::graph::graph(std::vector<int> offsets, std::vector<int> targets, std::vector<int> weights) :
+    offsets_(std::move(offsets)),
+    targets_(std::move(targets)),
+    weights_(std::move(weights))
+{
+    if (offsets_.empty() || targets_.size() != weights_.size() ||
+            offsets_.back() != static_cast<int>(targets_.size())) {
+        throw std::runtime_error("csr::graph: inconsistent arrays");
+    }
+}
+
+int aoc::csr::graph::size() const {
+    return static_cast<int>(offsets_.size()) - 1;
+}
+
+int aoc::csr::graph::num_edges() const {
+    return static_cast<int>(targets_.size());
+}
+
+int aoc::csr::graph::degree(int u) const {
+    return offsets_[u + 1] - offsets_[u];
+}
+
+std::span<const int> aoc::csr::graph::neighbors(int u) const {
+    return { targets_.data() + offsets_[u], targets_.data() + offsets_[u + 1] };
+}
+
+std::span<const int> aoc::csr::graph::weights(int u) const {
+    return { weights_.data() + offsets_[u], weights_.data() + offsets_[u + 1] };
+}
+
+aoc::csr::graph aoc::csr::graph::reversed() const {
+    std::vector<edge> edges;
+    edges.reserve(targets_.size());
+    for (int u = 0; u < size(); ++u) {
+        for (int i = offsets_[u]; i < offsets_[u + 1]; ++i) {
+            edges.push_back({ targets_[i], u, weights_[i] });
+        }
+    }
+    return graph(size(), edges);
+}
+
+const std::vector<int>& aoc::csr::graph::offsets() const {
+    return offsets_;
+}
+
+const std::vector<int>& aoc::csr::graph::targets() const {
+    return targets_;
+}
+
+const std::vector<int>& aoc::csr::graph::weights() const {
+    return weights_;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+std::span<const int> aoc::csr::bfs(const graph& g, std::span<const int> sources, bfs_workspace& ws) {
+    auto n = static_cast<size_t>(g.size());
+    ws.dist.assign(n, k_unreachable);
+    ws.queue.resize(n);
+
+    // each vertex is queued at most once, so the queue is a flat array with a read cursor
+    size_t head = 0;
+    size_t tail = 0;
+    for (int s : sources) {
+        if (ws.dist[s] == k_unreachable) {
+            ws.dist[s] = 0;
+            ws.queue[tail++] = s;
+        }
+    }
+    while (head < tail) {
+        int u = ws.queue[head++];
+        int d = ws.dist[u] + 1;
+        for (int v : g.neighbors(u)) {
+            if (ws.dist[v] == k_unreachable) {
+                ws.dist[v] = d;
+                ws.queue[tail++] = v;
+            }
+        }
+    }
+    return ws.dist;
+}
+
+std::span<const int> aoc::csr::bfs(const graph& g, int source, bfs_workspace& ws) {
+    return bfs(g, std::span<const int>(&source, 1), ws);
+}
+
+std::vector<int> aoc::csr::all_pairs_bfs(const graph& g) {
+    auto n = static_cast<size_t>(g.size());
+    std::vector<int> dist(n * n);
+    bfs_workspace ws;
+    for (int u = 0; u < g.size(); ++u) {
+        auto row = bfs(g, u, ws);
+        std::copy(row.begin(), row.end(), dist.begin() + u * n);
+    }
+    return dist;
+}
+
+std::optional<std::vector<int>> aoc::csr::topological_order(const graph& g) {
+    std::vector<int> in_degree(g.size(), 0);
+    for (int v : g.targets()) {
+        ++in_degree[v];
+    }
+    std::vector<int> order;
+    order.reserve(g.size());
+    for (int u = 0; u < g.size(); ++u) {
+        if (in_degree[u] == 0) {
+            order.push_back(u);
+        }
+    }
+    for (size_t i = 0; i < order.size(); ++i) {
+        for (int v : g.neighbors(order[i])) {
+            if (--in_degree[v] == 0) {
+                order.push_back(v);
+            }
+        }
+    }
+    if (static_cast<int>(order.size()) != g.size()) {
+        return {};
+    }
+    return order;
+}
+
+std::vector<int> aoc::csr::post_order(const graph& g, int root) {
+    // an explicit stack of (vertex, next neighbour slot) so that deep graphs cannot overflow
+    // the call stack
+    std::vector<int> order;
+    std::vector<char> visited(g.size(), 0);
+    std::vector<std::pair<int, int>> stack = { { root, 0 } };
+    visited[root] = 1;
+    while (!stack.empty()) {
+        auto& [u, i] = stack.back();
+        auto neighbors = g.neighbors(u);
+        if (i < static_cast<int>(neighbors.size())) {
+            int v = neighbors[i++];
+            if (!visited[v]) {
+                visited[v] = 1;
+                stack.push_back({ v, 0 });
+            }
+            continue;
+        }
+        order.push_back(u);
+        stack.pop_back();
+    }
+    return order;
+}
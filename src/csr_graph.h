@@ -0,0 +1,87 @@
+#pragma once
+
+#include <optional>
+#include <span>
+#include <vector>
+
+/*------------------------------------------------------------------------------------------------*/
+
+// a directed graph in compressed sparse row form: the out-edges of vertex u are the slots
+// offsets[u] to offsets[u + 1] of one targets array, and of a parallel weights array, so walking
+// a vertex's neighbours is a walk over contiguous memory. vertices are 0 to size() - 1 and the
+// graph is immutable once built; an undirected graph is one with each edge in both directions.
+//
+// the kernels below take their scratch space from the caller where they are meant to be run
+// many times, so that repeated queries on one graph do not allocate.
+
+namespace aoc::csr {
+
+    struct edge {
+        int from;
+        int to;
+        int weight = 1;
+    };
+
+    class graph {
+        std::vector<int> offsets_;
+        std::vector<int> targets_;
+        std::vector<int> weights_;
+
+    public:
+        graph(int num_vertices = 0, const std::vector<edge>& edges = {});
+
+        // from the raw arrays, e.g. as saved by the disk cache
+        graph(std::vector<int> offsets, std::vector<int> targets, std::vector<int> weights);
+
+        int size() const;
+        int num_edges() const;
+        int degree(int u) const;
+
+        // u's out-neighbours and the weights of the matching edges, in the order the edges
+        // were given
+        std::span<const int> neighbors(int u) const;
+        std::span<const int> weights(int u) const;
+
+        graph reversed() const;
+
+        const std::vector<int>& offsets() const;
+        const std::vector<int>& targets() const;
+        const std::vector<int>& weights() const;
+    };
+
+    constexpr int k_unreachable = -1;
+
+    // scratch space for bfs, reused across calls
+    struct bfs_workspace {
+        std::vector<int> dist;
+        std::vector<int> queue;
+    };
+
+    // distances, in edges, from the nearest of the sources; k_unreachable where there is no path.
+    // the result lives in ws and is overwritten by the next call.
+    std::span<const int> bfs(const graph& g, std::span<const int> sources, bfs_workspace& ws);
+    std::span<const int> bfs(const graph& g, int source, bfs_workspace& ws);
+
+    // the n x n table of bfs distances, row u holding the distances from u
+    std::vector<int> all_pairs_bfs(const graph& g);
+
+    // every vertex, each before all of its out-neighbours; nothing if the graph has a cycle
+    std::optional<std::vector<int>> topological_order(const graph& g);
+
+    // the vertices reachable from root, each after all of its out-neighbours. the graph must be
+    // acyclic from root.
+    std::vector<int> post_order(const graph& g, int root);
+
+    // folds each vertex's out-neighbours into it, values[u] = combine(values[u], values[v]),
+    // visiting the vertices in order. with a post order, or a reversed topological order, each
+    // vertex ends up aggregating everything below it: e.g. subtree totals in a tree.
+    template <typename T, typename Combine>
+    void aggregate(const graph& g, std::span<const int> order, std::vector<T>& values,
+            Combine combine) {
+        for (int u : order) {
+            for (int v : g.neighbors(u)) {
+                values[u] = combine(values[u], values[v]);
+            }
+        }
+    }
+}
@@ -1,8 +1,10 @@
 #include "util.h"
 #include "days.h"
+#include "simd.h"
 #include <range/v3/all.hpp>
 #include <iostream>
-#include <filesystem>
+#include <algorithm>
+#include <bit>
 #include <functional>
 
 namespace r = ranges;
@@ -10,26 +12,162 @@ namespace rv = ranges::views;
 
 /*------------------------------------------------------------------------------------------------*/
 
-void aoc::day_1(const std::string& title) {
-    auto input = file_to_string_vector( input_path(1,1) );
-    auto sorted_calories =
-        input | 
-        rv::chunk_by([](auto lhs, auto rhs) {return is_number(lhs) && is_number(rhs); }) |
-        rv::remove_if([](auto group) {return group.front().empty(); }) |
-        rv::transform(
-            [](auto group) {
-                return r::accumulate(
-                    group | rv::transform([](const auto& str) {return std::stoi(str); }), 0
+namespace {
+
+    // the k largest values pushed so far, kept as a min-heap so that the smallest of them is at
+    // the front and is the only one a new value has to beat
+    template <typename T>
+    class top_k {
+        std::vector<T> heap_;
+        size_t k_;
+
+    public:
+        explicit top_k(size_t k) : k_(k) {
+            heap_.reserve(k);
+        }
+
+        void push(T val) {
+            if (heap_.size() < k_) {
+                heap_.push_back(val);
+                std::push_heap(heap_.begin(), heap_.end(), std::greater<T>());
+            } else if (k_ > 0 && val > heap_.front()) {
+                std::pop_heap(heap_.begin(), heap_.end(), std::greater<T>());
+                heap_.back() = val;
+                std::push_heap(heap_.begin(), heap_.end(), std::greater<T>());
+            }
+        }
+
+        void merge(const top_k& other) {
+            for (auto val : other.heap_) {
+                push(val);
+            }
+        }
+
+        // largest first
+        std::vector<T> values() const {
+            auto vals = heap_;
+            std::sort(vals.begin(), vals.end(), std::greater<T>());
+            return vals;
+        }
+    };
+
+    // calls on_total with each elf's total, in order, straight from the text. the line breaks of
+    // each 64 bytes are found at once with a simd compare; a line's number is then built up
+    // digit by digit, and a line without digits ends the current elf.
+    template <typename F>
+    void for_each_elf_total(const char* ptr, const char* end, F on_total) {
+        int64_t total = 0;
+        bool elf_has_items = false;
+        auto end_line = [&](const char* from, const char* to) {
+            int64_t value = 0;
+            bool has_digits = false;
+            for (; from != to; ++from) {
+                auto digit = static_cast<unsigned>(*from - '0');
+                if (digit < 10) {
+                    value = value * 10 + digit;
+                    has_digits = true;
+                }
+            }
+            if (has_digits) {
+                total += value;
+                elf_has_items = true;
+            } else if (elf_has_items) {
+                on_total(total);
+                total = 0;
+                elf_has_items = false;
+            }
+        };
+
+        const char* line = ptr;
+        const char* block = ptr;
+        for (; end - block >= 64; block += 64) {
+            for (auto breaks = aoc::simd::match_mask_64(block, '\n'); breaks; breaks &= breaks - 1) {
+                auto line_end = block + std::countr_zero(breaks);
+                end_line(line, line_end);
+                line = line_end + 1;
+            }
+        }
+        for (; block != end; ++block) {
+            if (*block == '\n') {
+                end_line(line, block);
+                line = block + 1;
+            }
+        }
+        end_line(line, end);
+        if (elf_has_items) {
+            on_total(total);
+        }
+    }
+
+    // just past the first blank line at or after ptr, where no elf is part way through, or end
+    const char* after_blank_line(const char* ptr, const char* end) {
+        while (ptr != end) {
+            auto line_end = ptr + aoc::simd::find_byte(ptr, end - ptr, '\n');
+            if (line_end == end) {
+                return end;
+            }
+            ptr = line_end + 1;
+            auto next = (ptr != end && *ptr == '\r') ? ptr + 1 : ptr;
+            if (next != end && *next == '\n') {
+                return next + 1;
+            }
+        }
+        return end;
+    }
+
+    constexpr size_t k_chunk_bytes = 1 << 20;
+    constexpr size_t k_max_chunks = 256;
+
+    // the text cut into about one chunk per megabyte, each cut moved forward to the end of a
+    // blank line so that every elf lies wholly inside one chunk. the cuts depend only on the
+    // text, so the chunks, and the order their results are merged in, are the same everywhere.
+    std::vector<const char*> chunk_at_elf_boundaries(const char* data, size_t n) {
+        auto chunks = std::clamp<size_t>(n / k_chunk_bytes, 1, k_max_chunks);
+        std::vector<const char*> cuts = { data };
+        for (size_t i = 1; i < chunks; ++i) {
+            auto cut = after_blank_line(std::max(data + n * i / chunks, cuts.back()), data + n);
+            if (cut != data + n && cut != cuts.back()) {
+                cuts.push_back(cut);
+            }
+        }
+        cuts.push_back(data + n);
+        return cuts;
+    }
+
+    // the k largest elf totals, largest first. each chunk keeps its own top k in O(k) memory
+    // and the per-chunk results are merged in chunk order.
+    std::vector<int64_t> top_elf_totals(const char* data, size_t n, size_t k) {
+        auto cuts = chunk_at_elf_boundaries(data, n);
+        auto top = aoc::parallel_transform_reduce(
+            0, static_cast<int64_t>(cuts.size()) - 1, top_k<int64_t>(k),
+            [](top_k<int64_t> lhs, const top_k<int64_t>& rhs) {
+                lhs.merge(rhs);
+                return lhs;
+            },
+            [&](int64_t chunk) {
+                top_k<int64_t> chunk_top(k);
+                for_each_elf_total(cuts[chunk], cuts[chunk + 1],
+                    [&chunk_top](int64_t total) {
+                        chunk_top.push(total);
+                    }
                 );
+                return chunk_top;
             }
-        ) |
-        r::to_vector |
-        r::actions::sort(std::greater<int>());
+        );
+        return top.values();
+    }
+}
+
+void aoc::day_1(const std::string& title) {
+    // mapped rather than read so that a huge calorie log is streamed through the page cache
+    aoc::mapped_file input(input_path(1, 1));
+    auto top_calories = top_elf_totals(input.data(), input.size(), 3);
 
-    auto max_calories_1_elf = sorted_calories.front();
-    auto max_calories_3_elves = r::accumulate( sorted_calories | rv::take(3), 0);
+    // an empty log has no elves, and so no calories to report
+    auto max_calories_1_elf = top_calories.empty() ? static_cast<int64_t>(0) : top_calories.front();
+    auto max_calories_3_elves = r::accumulate(top_calories | rv::take(3), static_cast<int64_t>(0));
 
     std::cout << header(1, title);
     std::cout << "  part 1: " << max_calories_1_elf << "\n";
     std::cout << "  part 2: " << max_calories_3_elves << "\n";
-}
\ No newline at end of file
+}
@@ -1,11 +1,17 @@
 #include "util.h"
 #include "days.h"
+#ifdef AOC_EMBED_INPUT
+#include "embedded_input.h"
+#endif
 #include <range/v3/all.hpp>
 #include <iostream>
 #include <filesystem>
 #include <functional>
 #include <tuple>
 #include <sstream>
+#include <span>
+#include <string_view>
+#include <array>
 
 namespace r = ranges;
 namespace rv = ranges::views;
@@ -30,6 +36,7 @@ namespace{
         int end_cycle;
     };
     
+#ifndef AOC_EMBED_INPUT
     instruction parse_line_of_input(const std::string& line) {
         auto pieces = aoc::split(line, ' ');
         bool is_noop = pieces[0] == "noop";
@@ -37,6 +44,43 @@ namespace{
         int incr = is_noop ? 0 : std::stoi(pieces[1]);
         return { duration, incr };
     }
+#else
+    constexpr size_t count_lines(std::string_view str) {
+        size_t n = 0;
+        for (char ch : str) {
+            n += (ch == '\n') ? 1 : 0;
+        }
+        return (!str.empty() && str.back() != '\n') ? n + 1 : n;
+    }
+
+    template <size_t N>
+    constexpr std::array<instruction, N> parse_program(std::string_view input) {
+        std::array<instruction, N> prog{};
+        size_t pos = 0;
+        for (auto& instr : prog) {
+            auto eol = input.find('\n', pos);
+            auto line = input.substr(pos, eol - pos);
+            if (line.starts_with("noop")) {
+                instr = { 1, 0 };
+            } else {
+                size_t i = 5; // "addx "
+                bool negative = (line[i] == '-');
+                i += negative ? 1 : 0;
+                int incr = 0;
+                for (; i < line.size(); ++i) {
+                    incr = 10 * incr + (line[i] - '0');
+                }
+                instr = { 2, negative ? -incr : incr };
+            }
+            pos = eol + 1;
+        }
+        return prog;
+    }
+
+    constexpr auto k_embedded_program = parse_program<count_lines(aoc::embedded::day_10)>(
+        aoc::embedded::day_10
+    );
+#endif
 
     std::tuple<cpu_state_range, cpu_state> execute_statement(
             const instruction& instruction, const cpu_state& state) {
@@ -50,7 +94,7 @@ namespace{
         return { cpu_states, next_cpu_state };
     }
 
-    int sum_of_signal_strengths(const program& prog) {
+    int sum_of_signal_strengths(std::span<const instruction> prog) {
         cpu_state cpu;
         int sum_of_strengths = 0;
         for (const auto& instruction : prog) {
@@ -65,7 +109,7 @@ namespace{
         return sum_of_strengths;
     }
 
-    std::string draw_rasters(const program& prog) {
+    std::string draw_rasters(std::span<const instruction> prog) {
         constexpr auto columns = 40;
         std::stringstream ss;
         cpu_state cpu;
@@ -91,8 +135,12 @@ namespace{
 }
 
 void aoc::day_10(const std::string& title) {
+#ifdef AOC_EMBED_INPUT
+    const auto& prog = k_embedded_program;
+#else
     auto input = file_to_string_vector(input_path(10, 1));
     auto prog = input | rv::transform(parse_line_of_input) | r::to_vector;
+#endif
 
     std::cout << header(10, title);
     std::cout << "  part 1: " << sum_of_signal_strengths(prog ) << "\n\n";
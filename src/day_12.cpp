@@ -1,13 +1,10 @@
 #include "util.h"
 #include "days.h"
+#include "search.h"
 #include <range/v3/all.hpp>
 #include <iostream>
 #include <filesystem>
 #include <functional>
-#include <limits>
-#include <map>
-#include <boost/functional/hash.hpp>
-#include <unordered_map>
 #include <sstream>
 #include <array>
 
@@ -65,52 +62,6 @@ namespace {
         return hm;
     }
 
-    struct grid_loc_hasher {
-        size_t operator()(const grid_loc& loc) const {
-            size_t seed = 0;
-            boost::hash_combine(seed, loc.col);
-            boost::hash_combine(seed, loc.row);
-            return seed;
-        }
-    };
-
-    template<typename T>
-    using loc_map = std::unordered_map<grid_loc, T, grid_loc_hasher>;
-
-    class priority_queue {
-        using map_impl = std::multimap<int, grid_loc>;
-        map_impl priority_to_loc_;
-        loc_map<map_impl::iterator> loc_to_mmap_iter_;
-
-    public:
-        priority_queue()
-        {}
-
-        grid_loc extract_min() {
-            auto first = priority_to_loc_.begin();
-            auto loc = first->second;
-            priority_to_loc_.erase(first);
-            loc_to_mmap_iter_.erase(loc);
-            return loc;
-        }
-
-        void insert(const grid_loc& loc, int priority) {
-            auto iter = priority_to_loc_.insert({ priority, loc });
-            loc_to_mmap_iter_[loc] = iter;
-        }
-
-        void change_priority(const grid_loc& loc, int priority) {
-            auto iter = loc_to_mmap_iter_[loc];
-            priority_to_loc_.erase(iter);
-            loc_to_mmap_iter_.erase(loc);
-            insert(loc, priority);
-        }
-
-        bool empty() const {
-            return priority_to_loc_.empty();
-        }
-    };
-
     template<typename T>
     std::tuple<int, int> dimensions(const grid<T>& g) {
         return {
@@ -119,15 +70,6 @@ namespace {
         };
     }
 
-    template<typename T>
-    grid<T> init_grid(std::tuple<int, int> dim, T val) {
-        auto [wd, hgt] = dim;
-        return grid<T>(
-            hgt, 
-            std::vector<T>(wd, val)
-        );
-    }
-
     template<typename T>
     auto all_grid_locs(const grid<T>& g) {
         auto [wd, hgt] = dimensions(g);
@@ -176,31 +118,46 @@ namespace {
             );
      }
 
-    int dijkstra_shortest_path(const height_map& hgt_map) {
-        auto [wd,hgt] = dimensions(hgt_map.grid);
+    struct path_state {
+        grid_loc loc;
+        int dist;
+    };
 
-        grid<int> dist = init_grid({ wd,hgt }, wd * hgt + 1);
-        for (auto loc : hgt_map.src) {
-            dist[loc.row][loc.col] = 0;
+    class shortest_path_problem {
+        const height_map& hgt_map_;
+        int wd_;
+    public:
+        shortest_path_problem(const height_map& hgt_map) :
+            hgt_map_(hgt_map),
+            wd_(std::get<0>(dimensions(hgt_map.grid)))
+        {}
+
+        bool is_goal(const path_state& s) const {
+            return s.loc == hgt_map_.end;
         }
 
-        priority_queue queue;
-        for (grid_loc loc : all_grid_locs(hgt_map.grid)) {
-            queue.insert(loc, dist[loc.row][loc.col]);
+        uint64_t key(const path_state& s) const {
+            return static_cast<uint64_t>(s.loc.row) * wd_ + s.loc.col;
         }
 
-        while (!queue.empty()) {
-            auto u = queue.extract_min();
-            for (auto v : neighbors(hgt_map.grid, u)) {
-                auto dist_through_u = dist[u.row][u.col] + 1;
-                if (dist_through_u < dist[v.row][v.col]) {
-                    dist[v.row][v.col] = dist_through_u;
-                    queue.change_priority(v, dist_through_u);
-                }
+        int64_t priority(const path_state& s) const {
+            return s.dist;
+        }
+
+        void successors(const path_state& s, auto&& emit) const {
+            for (auto v : neighbors(hgt_map_.grid, s.loc)) {
+                emit(path_state{ v, s.dist + 1 });
             }
         }
+    };
 
-        return dist[hgt_map.end.row][hgt_map.end.col];
+    int dijkstra_shortest_path(const height_map& hgt_map) {
+        shortest_path_problem problem(hgt_map);
+        auto sources = hgt_map.src |
+            rv::transform([](auto&& loc)->path_state { return { loc, 0 }; }) |
+            r::to_vector;
+        auto result = aoc::search::best_first(problem, std::move(sources));
+        return result ? result->dist : -1;
     }
 
 }
@@ -1,14 +1,13 @@
 #include "util.h"
 #include "days.h"
+#include "counters.h"
 #include "peglib.h"
 #include <range/v3/all.hpp>
 #include <iostream>
 #include <functional>
-#include <memory>
-#include <variant>
+#include <span>
 #include <sstream>
-#include <tuple>
-#include <optional>
+#include <chrono>
 
 namespace r = ranges;
 namespace rv = ranges::views;
@@ -17,190 +16,192 @@ namespace rv = ranges::views;
 
 namespace {
 
-    struct wrapped_list;
-    using list = std::variant<int, std::vector<wrapped_list>>;
-    struct wrapped_list { list val; };
+    // every packet of the input in two flat arrays. a node is a number or a list, and a list's
+    // elements are a run of node ids in the element array; a number is given a run of one, its
+    // own id, so that comparing a number with a list needs no wrapping. the grammar's actions
+    // append to the store and hand node ids up the parse, so nothing is boxed but an int.
+    class packet_store {
+        struct node {
+            int value; // the number, or k_list
+            int first;
+            int size;
+        };
 
-    peg::parser make_parser() {
+        std::vector<node> nodes_;
+        std::vector<int> elements_;
+        std::vector<int> packets_;
 
-        std::stringstream ss;
-        ss << "ROOT <- Expr\n";
-        ss << "Number <- <[0-9]+>\n";
-        ss << "Expr <- '[' (Number/Expr)* ']'\n";
-        ss << "%whitespace <- [ ,]*\n";
+    public:
+        static constexpr int k_list = -1;
 
-        auto parser = peg::parser(ss.str());
-        
-        parser["Expr"] = [](const peg::SemanticValues& vs)->list {
-            return vs |
-                rv::transform(
-                    [](auto vsi)->wrapped_list {
-                        if (vsi.type() == typeid(int)) {
-                            return wrapped_list{ std::any_cast<int>(vsi) };
-                        } else {
-                            return wrapped_list{ std::any_cast<list>(vsi) };
-                        }
-                    }
-            ) | r::to_vector;
-        };
+        void reserve(size_t input_size) {
+            // every node starts at a character of its own
+            nodes_.reserve(input_size);
+            elements_.reserve(input_size);
+        }
 
-        parser["Number"] = [](const peg::SemanticValues& vs)->int {
-            return vs.token_to_number<int>();
-        };
+        int add_number(int value) {
+            int id = static_cast<int>(nodes_.size());
+            nodes_.push_back({ value, static_cast<int>(elements_.size()), 1 });
+            elements_.push_back(id);
+            return id;
+        }
 
-        return parser;
-    }
+        int add_list(const peg::SemanticValues& vs) {
+            int first = static_cast<int>(elements_.size());
+            for (const auto& element : vs) {
+                elements_.push_back(std::any_cast<int>(element));
+            }
+            nodes_.push_back({ k_list, first, static_cast<int>(vs.size()) });
+            return static_cast<int>(nodes_.size()) - 1;
+        }
 
-    std::string to_string(const list& list) {
-        struct visitor {
-            std::stringstream& ss;
-            visitor(std::stringstream& ss) : ss(ss) {}
-            void operator()(int val) const { ss << val; }
-            void operator()(const std::vector<wrapped_list>& lst) {
-                ss << "[ ";
-                for (const auto& itm : lst) {
-                    ss << to_string(itm.val) << " ";
-                }
-                ss << "]";
+        void add_packets(const peg::SemanticValues& vs) {
+            for (const auto& packet : vs) {
+                packets_.push_back(std::any_cast<int>(packet));
             }
-        };
-        std::stringstream ss;
-        std::visit( visitor(ss), list );
-        return ss.str();
-    }
+        }
 
-    list parse_list(const std::string& str) {
-        static auto parser = make_parser();
-        list expr;
-        bool success = parser.parse(str, expr);
-        if (!success) {
-            throw std::runtime_error("parsing failure");
+        bool is_number(int id) const {
+            return nodes_[id].value != k_list;
         }
-        return expr;
-    }
 
-    auto to_list_pairs(const std::vector<std::string>& lines) {
-        return lines |
-            rv::chunk_by(
-                [](auto&& lhs, auto&& rhs) { return !lhs.empty() && !rhs.empty(); }
-            ) | rv::remove_if(
-                [](auto rng) {return rng[0].empty();}
-            ) | rv::transform(
-                [](auto rng)->std::tuple<list, list> {
-                    return {
-                        parse_list(rng[0]),
-                        parse_list(rng[1])
-                    };
-                }
-            ) | r::to_vector;
-    }
+        int value(int id) const {
+            return nodes_[id].value;
+        }
 
-    auto to_lists(const std::vector<std::string>& lines) {
-        return lines |
-            rv::remove_if([](auto&& line) {return line.empty(); }) |
-            rv::transform(parse_list) |
-            r::to_vector;
-    }
+        std::span<const int> elements(int id) const {
+            const auto& n = nodes_[id];
+            return { elements_.data() + n.first, static_cast<size_t>(n.size) };
+        }
 
-    bool is_num(const list& lst) {
-        return std::holds_alternative<int>(lst);
+        const std::vector<int>& packets() const {
+            return packets_;
+        }
+    };
+
+#ifdef AOC_ENABLE_COUNTERS
+    // per-rule matching and semantic action costs, for telling the parser's own work apart
+    // from the building of the packet store done in the actions
+    void write_rule_profile(std::ostream& os, const std::map<std::string, peg::RuleStats>& stats) {
+        auto to_ms = [](auto duration) {
+            return std::chrono::duration<double, std::milli>(duration).count();
+        };
+        for (const auto& [name, rule] : stats) {
+            os << "    " << name << ": " << rule.invocations << " calls, " <<
+                rule.successes << " matched, " << rule.backtracks << " backtracked, " <<
+                to_ms(rule.time) << " ms";
+            if (rule.actions > 0) {
+                os << " (actions: " << rule.actions << " calls, " << to_ms(rule.action_time) << " ms)";
+            }
+            os << "\n";
+        }
     }
+#endif
 
-    list wrap_in_list(list val) {
-        std::vector<wrapped_list> lst = { wrapped_list{val} };
-        return lst;
-    }
+    // the whole file in one parse: packets separated by commas, spaces and line breaks, with the
+    // blank lines between pairs being just more whitespace
+    peg::parser make_parser() {
 
-    std::optional<bool> is_well_ordered(const list& lhs, const list& rhs) {
-        if (is_num(lhs) && is_num(rhs)) {
-            auto left = std::get<int>(lhs);
-            auto right = std::get<int>(rhs);
-            if (left < right) {
-                return true;
-            }
-            if (left > right) {
-                return false;
-            }
-            return {};
-        }
+        std::stringstream ss;
+        ss << "ROOT <- List*\n";
+        ss << "Number <- <[0-9]+>\n";
+        ss << "List <- '[' (Number/List)* ']'\n";
+        ss << "%whitespace <- [ ,\\r\\n]*\n";
 
-        if (!is_num(lhs) && !is_num(rhs)) {
-            const auto& left = std::get<std::vector<wrapped_list>>(lhs);
-            const auto& right = std::get<std::vector<wrapped_list>>(rhs);
-            auto n = std::min(left.size(), right.size());
-            for (size_t i = 0; i < n; ++i) {
-                auto result = is_well_ordered(left[i].val, right[i].val);
-                if (result) {
-                    return result;
-                }
-            }
-            if (left.size() < right.size()) {
-                return true;
-            }
-            if (left.size() > right.size()) {
-                return false;
-            }
-            return {};
-        }
+        auto parser = peg::parser(ss.str());
 
-        if (is_num(lhs)) {
-            return is_well_ordered(wrap_in_list(lhs), rhs);
-        }
+        auto store = [](std::any& dt)->packet_store& {
+            return *std::any_cast<packet_store*>(dt);
+        };
 
-        if (is_num(rhs)) {
-            return is_well_ordered(lhs, wrap_in_list(rhs));
-        }
+        parser["ROOT"] = [store](const peg::SemanticValues& vs, std::any& dt) {
+            store(dt).add_packets(vs);
+        };
 
-        return {};
-    }
+        parser["List"] = [store](const peg::SemanticValues& vs, std::any& dt) {
+            return store(dt).add_list(vs);
+        };
+
+        parser["Number"] = [store](const peg::SemanticValues& vs, std::any& dt) {
+            return store(dt).add_number(vs.token_to_number<int>());
+        };
 
-    int sum_of_indices_of_well_ordered_pairs(const auto& pairs) {
-        return r::accumulate(
-            rv::enumerate(pairs) |
-                rv::transform(
-                    [](auto&& index_pair)->int {
-                        const auto& [index, pair] = index_pair;
-                        const auto& [lhs, rhs] = pair;
-                        auto result = is_well_ordered(lhs, rhs);
-                        if (result.has_value() && result.value() == true) {
-                            return static_cast<int>(index) + 1;
-                        } else {
-                            return 0;
-                        }
-                    }
-                ),
-            0
+#ifdef AOC_ENABLE_COUNTERS
+        parser.enable_profiling();
+        aoc::counters::add_section("grammar rules",
+            [parser](std::ostream& os) { write_rule_profile(os, parser.profile()); }
         );
+#endif
+
+        return parser;
     }
 
-    int calculate_decoder_key(const std::vector<std::string>& input) {
-        auto lists = to_lists(input);
-        lists.emplace_back(parse_list("[[2]]"));
-        lists.emplace_back(parse_list("[[6]]"));
+    void parse_packets(const std::string& str, packet_store& store) {
+        static const auto parser = make_parser();
+        std::any dt = &store;
+        if (!parser.parse(str, dt)) {
+            throw std::runtime_error("parsing failure");
+        }
+    }
 
-        r::sort(lists,
-            [](const auto& lhs, const auto& rhs) {
-                auto result = is_well_ordered(lhs, rhs);
-                return result.has_value() && result.value();
+    // negative, zero or positive as lhs is before, level with or after rhs
+    int compare(const packet_store& store, int lhs, int rhs) {
+        if (store.is_number(lhs) && store.is_number(rhs)) {
+            return store.value(lhs) - store.value(rhs);
+        }
+        auto left = store.elements(lhs);
+        auto right = store.elements(rhs);
+        auto n = std::min(left.size(), right.size());
+        for (size_t i = 0; i < n; ++i) {
+            auto result = compare(store, left[i], right[i]);
+            if (result != 0) {
+                return result;
             }
-        );
+        }
+        return static_cast<int>(left.size()) - static_cast<int>(right.size());
+    }
 
-        int divider_packet_product = 1;
-        for (const auto& [index, lst] : rv::enumerate(lists)) {
-            auto stringified = to_string(lst);
-            if (stringified == "[ [ 2 ] ]" || stringified == "[ [ 6 ] ]") {
-                divider_packet_product *= static_cast<int>(index) + 1;
+    int sum_of_indices_of_well_ordered_pairs(const packet_store& store) {
+        const auto& packets = store.packets();
+        int sum = 0;
+        for (size_t i = 0; i + 1 < packets.size(); i += 2) {
+            if (compare(store, packets[i], packets[i + 1]) < 0) {
+                sum += static_cast<int>(i / 2) + 1;
             }
         }
+        return sum;
+    }
 
-        return divider_packet_product;
+    // the dividers' places in the sorted packets are one more than the number of packets
+    // before them, with [[2]] also before [[6]], so there is no need to sort
+    int calculate_decoder_key(packet_store& store) {
+        auto num_packets = store.packets().size();
+        parse_packets("[[2]]\n[[6]]\n", store);
+        auto first_divider = store.packets()[num_packets];
+        auto second_divider = store.packets()[num_packets + 1];
+
+        int first_index = 1;
+        int second_index = 2;
+        for (auto packet : store.packets() | rv::take(num_packets)) {
+            if (compare(store, packet, first_divider) < 0) {
+                ++first_index;
+            }
+            if (compare(store, packet, second_divider) < 0) {
+                ++second_index;
+            }
+        }
+        return first_index * second_index;
     }
 }
 
 void aoc::day_13(const std::string& title) {
-    auto input = file_to_string_vector(input_path(13, 1));
+    auto input = file_to_string(input_path(13, 1));
+    packet_store store;
+    store.reserve(input.size());
+    parse_packets(input, store);
+
     std::cout << header(13, title);
-    auto list_pairs = to_list_pairs(input);
-    std::cout << "  part 1: " << sum_of_indices_of_well_ordered_pairs(list_pairs) << "\n";
-    std::cout << "  part 2: " << calculate_decoder_key(input) << "\n";
-}
\ No newline at end of file
+    std::cout << "  part 1: " << sum_of_indices_of_well_ordered_pairs(store) << "\n";
+    std::cout << "  part 2: " << calculate_decoder_key(store) << "\n";
+}
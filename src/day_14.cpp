@@ -1,5 +1,8 @@
 #include "util.h"
 #include "days.h"
+#include "counters.h"
+#include "bitplane.h"
+#include "checkpoint.h"
 #include <range/v3/all.hpp>
 #include <iostream>
 #include <functional>
@@ -15,39 +18,39 @@ namespace {
         int x, y;
     };
 
-    enum class tile {
-        empty,
-        wall,
-        sand
-    };
-
+    // occupied cells, wall or sand, of the columns x1 to x2 and rows 0 to y2
     class grid {
-        std::vector<std::vector<tile>> ary_;
+        aoc::bits::plane occupied_;
         int min_x_;
     public:
         grid(int x1, int x2, int y2) : 
-            min_x_(x1),
-            ary_(y2+1, std::vector<tile>(x2-x1+1, tile::empty))
+            occupied_(x2 - x1 + 1, y2 + 1),
+            min_x_(x1)
         {}
 
-        tile at(const point& pt) const {
-            if (!contains(pt)) {
-                return tile::empty;
-            }
-            return ary_[pt.y][pt.x - min_x_];
+        bool is_empty(int x, int y) const {
+            return !occupied_.test(x - min_x_, y);
         }
 
-        tile at(int x, int y) const {
-            return at(point{ x,y });
+        bool is_empty(const point& pt) const {
+            return is_empty(pt.x, pt.y);
         }
 
         bool contains(const point& pt) const {
-            return pt.x >= min_x_ && pt.x < min_x_ + static_cast<int>(ary_[0].size()) &&
-                pt.y >= 0 && pt.y < static_cast<int>(ary_.size());
+            return pt.x >= min_x_ && pt.x < min_x_ + occupied_.width() &&
+                pt.y >= 0 && pt.y < occupied_.height();
+        }
+
+        void fill(const point& pt) {
+            occupied_.set(pt.x - min_x_, pt.y);
         }
 
-        void set(const point& pt, tile t) {
-            ary_[pt.y][pt.x - min_x_] = t;
+        const aoc::bits::plane& occupied() const {
+            return occupied_;
+        }
+
+        aoc::bits::plane& occupied() {
+            return occupied_;
         }
     };
 
@@ -76,7 +79,7 @@ namespace {
     void draw_polyline(grid& g, const std::vector<point>& polyline) {
         for (auto line : polyline | rv::sliding(2)) {
             for (auto pt : points_between(line[0], line[1])) {
-                g.set(pt, tile::wall);
+                g.fill(pt);
             }
         }
     }
@@ -115,40 +118,68 @@ namespace {
 
     bool drop_sand_grain(grid& g) {
         point pt = { 500,0 };
-        if (g.at(pt) != tile::empty) {
+        if (!g.is_empty(pt)) {
             return false;
         }
+        AOC_COUNT(grains_dropped);
         bool done = false;
         while (g.contains(pt)) {
-            if (g.at(pt.x, pt.y + 1) == tile::empty) {
+            if (g.is_empty(pt.x, pt.y + 1)) {
                 pt = { pt.x, pt.y + 1 };
+                AOC_COUNT(sand_steps);
                 continue;
             }
-            if (g.at(pt.x - 1, pt.y + 1) == tile::empty) {
+            if (g.is_empty(pt.x - 1, pt.y + 1)) {
                 pt = {pt.x - 1, pt.y + 1};
+                AOC_COUNT(sand_steps);
                 continue;
             }
-            if (g.at(pt.x + 1, pt.y + 1) == tile::empty) {
+            if (g.is_empty(pt.x + 1, pt.y + 1)) {
                 pt = {pt.x + 1, pt.y + 1};
+                AOC_COUNT(sand_steps);
                 continue;
             }
             break;
         } 
         if (g.contains(pt)) {
-            g.set(pt, tile::sand);
+            g.fill(pt);
             return true;
         }
         return false;
     }
 
     int drop_sand(grid& g) {
+        auto& occupied = g.occupied();
+        auto walls_hash = aoc::cache::hash_bytes(
+            occupied.words().data(), occupied.words().size() * sizeof(uint64_t)
+        );
+        aoc::checkpoint::snapshot snapshot("day_14_sand", 1, walls_hash);
         bool added_sand;
         int count = 0;
+        snapshot.restore(
+            [&](aoc::cache::blob_reader& in) {
+                auto saved_count = in.read<int>();
+                auto words = in.read_vector<uint64_t>();
+                if (saved_count < 0 || words.size() != occupied.words().size()) {
+                    throw std::runtime_error("bad day 14 checkpoint");
+                }
+                count = saved_count;
+                occupied.words() = std::move(words);
+            }
+        );
+
         do {
+            snapshot.tick(
+                [&](aoc::cache::blob_writer& out) {
+                    out.write(count);
+                    out.write_vector(occupied.words());
+                }
+            );
             added_sand = drop_sand_grain(g);
             count += (added_sand) ? 1 : 0;
         } while (added_sand);
 
+        snapshot.finish();
         return count;
     }
 
@@ -161,6 +192,8 @@ namespace {
         return drop_sand(g);
     }
 
+    // with a floor, sand comes to rest in exactly the cells that are not rock and lie below a
+    // resting grain, so the whole pile is one downward flood fill from the source.
     int do_part_2(const std::vector<std::vector<point>>& input) {
         auto polylines = input;
         auto [x1, y1, x2, y2] = polylines_to_bounds(polylines);
@@ -172,7 +205,19 @@ namespace {
         for (const auto& polyline : polylines) {
             draw_polyline(g, polyline);
         }
-        return drop_sand(g);
+
+        auto open = ~g.occupied();
+        aoc::bits::plane sand(open.width(), open.height());
+        sand.set(500 - x1, 0);
+        while (true) {
+            auto next = sand | sand.shifted(-1, 1) | sand.shifted(0, 1) | sand.shifted(1, 1);
+            next &= open;
+            if (next == sand) {
+                break;
+            }
+            sand = std::move(next);
+        }
+        return static_cast<int>(sand.count());
     }
 }
 
@@ -182,8 +227,13 @@ void aoc::day_14(const std::string& title) {
     auto input = file_to_string_vector(input_path(14, 1));
     auto polylines = to_polylines(input);
 
+    auto [part_1, part_2] = aoc::parallel_invoke(
+        [&polylines]() { return do_part_1(polylines); },
+        [&polylines]() { return do_part_2(polylines); }
+    );
+
     std::cout << header(14, title);
 
-    std::cout << "  part 1: " << do_part_1(polylines) << "\n";
-    std::cout << "  part 2: " << do_part_2(polylines) << "\n";
+    std::cout << "  part 1: " << part_1 << "\n";
+    std::cout << "  part 2: " << part_2 << "\n";
 }
\ No newline at end of file
@@ -234,11 +234,13 @@ namespace {
             0
         );
 
-        int count = 0;
-        for (int x = bounds.x1; x <= bounds.x2; ++x) {
-            point pt = { x, row };
-            count += in_sensor_zone(sensors, pt) ? 1 : 0;
-        }
+        int count = aoc::parallel_transform_reduce(
+            bounds.x1, static_cast<int64_t>(bounds.x2) + 1, 0, std::plus<int>(),
+            [&sensors, row](int64_t x)->int {
+                point pt = { static_cast<int>(x), row };
+                return in_sensor_zone(sensors, pt) ? 1 : 0;
+            }
+        );
         return count - num_beacons_on_row;
     }
 
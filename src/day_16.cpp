@@ -1,23 +1,24 @@
 #include "util.h"
 #include "days.h"
+#include "search.h"
+#include "cache.h"
+#include "interner.h"
+#include "small_vector.h"
+#include "csr_graph.h"
 #include <range/v3/all.hpp>
 #include <iostream>
 #include <functional>
-#include <unordered_map>
-#include <map>
-#include <stack>
-#include <boost/functional/hash.hpp>
-#include <unordered_set>
 
 namespace r = ranges;
 namespace rv = ranges::views;
 
 namespace {
 
+    // valves are referred to by their interned labels
     struct vertex_info {
-        std::string label;
+        int label;
         int flow;
-        std::vector<std::string> neighbors;
+        std::vector<int> neighbors;
     };
 
     struct edge {
@@ -25,145 +26,117 @@ namespace {
         int dest;
     };
 
-    struct vertex {
-        std::string label;
-        int index;
-        int flow;
-        std::vector<edge> neighbors;
-    };
-
+    // the valves as a weighted graph, an edge's weight being the minutes it takes to walk
     struct graph {
         int start;
-        std::vector<vertex> verts;
+        std::vector<int> flow;
+        aoc::csr::graph tunnels;
+
+        int size() const {
+            return tunnels.size();
+        }
     };
 
-    vertex_info parse_line_of_input(const std::string& line) {
+    vertex_info parse_line_of_input(const std::string& line, aoc::interner& labels) {
         auto pieces = aoc::split(line, ' ');
         return {
-            pieces[1],
+            labels.intern(pieces[1]),
             std::stoi(aoc::remove_nonnumeric(pieces[4])),
             pieces |
                 rv::drop(9) |
-                rv::transform(aoc::remove_nonalphabetic) |
-                r::to_vector
+                rv::transform(
+                    [&labels](const std::string& piece) {
+                        return labels.intern(aoc::remove_nonalphabetic(piece));
+                    }
+                ) | r::to_vector
         };
     }
 
     graph build_graph(const std::vector<std::string>& input) {
-        auto inp = input | rv::transform(parse_line_of_input) | r::to_vector;
-        std::unordered_map<std::string, int> label_to_index;
-        std::vector<vertex> vertices = rv::enumerate(inp) |
+        // intern each line's own valve first so that a valve's id is its vertex index
+        aoc::interner labels;
+        for (const auto& line : input) {
+            labels.intern(aoc::split(line, ' ')[1]);
+        }
+        auto inp = input |
             rv::transform(
-                [&label_to_index](const auto& p)->vertex {
-                    auto [index, vi] = p;
-                    vertex v;
-                    v.label = vi.label;
-                    v.index = static_cast<int>(index);
-                    v.flow = vi.flow;
-
-                    label_to_index[v.label] = v.index;
-                    return v;
+                [&labels](const std::string& line) {
+                    return parse_line_of_input(line, labels);
                 }
             ) | r::to_vector;
+        int n = static_cast<int>(inp.size());
+        std::vector<int> flow(n);
+        std::vector<aoc::csr::edge> edges;
         for (const auto& vi : inp) {
-            auto& v = vertices[label_to_index[vi.label]];
-            v.neighbors = vi.neighbors |
-                rv::transform(
-                    [&label_to_index](const auto& lbl)->edge {
-                        return { 1, label_to_index[lbl] };
-                    }
-                ) | r::to_vector;
+            flow[vi.label] = vi.flow;
+            for (int v : vi.neighbors) {
+                edges.push_back({ vi.label, v });
+            }
         }
         return graph{
-            label_to_index["AA"],
-            std::move(vertices)
+            labels.id("AA"),
+            std::move(flow),
+            aoc::csr::graph(n, edges)
         };
     }
 
-    int length_of_shortest_path(const graph& g, int src, int dest) {
-        std::unordered_map<int, int> distance;
-        std::function<void(int, int)> dfs;
-        dfs = [&](int u, int depth)->void {
-            if (distance.contains(u)) {
-                if (depth < distance[u]) {
-                    distance[u] = depth;
-                }
-                return;
+    // keeps the start and the working valves, joined directly by their walking distances
+    graph build_weighted_graph(const graph& g, const std::vector<int>& dist) {
+        int n = g.size();
+        std::vector<int> new_index_to_old_index;
+        for (int u = 0; u < n; ++u) {
+            if (g.flow[u] != 0 || u == g.start) {
+                new_index_to_old_index.push_back(u);
             }
-            distance[u] = depth;
-            if (u == dest) {
-                return;
-            }
-            for (int v : g.verts[u].neighbors |  rv::transform(  [](auto&& e) { return e.dest;  } )) {
-                dfs(v, depth + 1);
-            }
-            return;
-        };
-        dfs(src, 0);
-        return distance[dest];
-    }
-
-    std::vector<std::vector<int>> shortest_path_lengths(const graph& g) {
-        int n = static_cast<int>(g.verts.size());
-        std::vector<std::vector<int>> tbl(n, std::vector<int>(n, 0));
-        for (auto [u, v] : rv::cartesian_product(rv::iota(0, n), rv::iota(0, n))) {
-            tbl[u][v] = length_of_shortest_path(g, u, v);
-            tbl[v][u] = tbl[u][v];
         }
-        return tbl;
-    }
-
-    graph build_weighted_graph(const graph& g, std::vector<std::vector<int>>& dist) {
-        std::unordered_map<int, int> new_index_to_old_index =
-            rv::enumerate(
-                g.verts |
-                rv::remove_if(
-                    [&](auto&& u) {
-                        return u.flow == 0 && u.index != g.start;
-                    }
-                )
-            ) | rv::transform(
-                [](auto&& i_u)->std::unordered_map<int, int>::value_type {
-                    auto [i, u] = i_u;
-                    return { static_cast<int>(i), u.index };
-                }
-            ) | r::to< std::unordered_map<int, int>>();
-        int n = static_cast<int>(new_index_to_old_index.size());
+        int m = static_cast<int>(new_index_to_old_index.size());
 
         graph weighted_graph;
-        for (int new_index : rv::iota(0, n)) {
-            std::vector<edge> edges;
+        std::vector<aoc::csr::edge> edges;
+        for (int new_index = 0; new_index < m; ++new_index) {
             int old_index = new_index_to_old_index[new_index];
-            for (int v : rv::iota(0, n)) {
-                if (v == new_index) {
-                    continue;
-                }
-                if (g.verts[new_index_to_old_index[v]].flow == 0) {
+            for (int v = 0; v < m; ++v) {
+                int old_v = new_index_to_old_index[v];
+                auto distance = dist[old_index * n + old_v];
+                // a valve with no path to it gets no edge, and so is never opened
+                if (v == new_index || g.flow[old_v] == 0 || distance == aoc::csr::k_unreachable) {
                     continue;
                 }
-                edges.push_back( 
-                    edge {
-                        dist[old_index][new_index_to_old_index[v]],
-                        v
-                    }
-                );
+                edges.push_back({ new_index, v, distance });
             }
-            const auto& old_vert = g.verts[old_index];
-            if (old_vert.label == "AA") {
+            if (old_index == g.start) {
                 weighted_graph.start = new_index;
             }
-            weighted_graph.verts.push_back(
-                vertex{
-                    .label = old_vert.label,
-                    .index = new_index,
-                    .flow = old_vert.flow,
-                    .neighbors = edges
-                }
-            );
+            weighted_graph.flow.push_back(g.flow[old_index]);
         }
+        weighted_graph.tunnels = aoc::csr::graph(m, edges);
         return weighted_graph;
     }
 
+    graph build_valve_graph(const std::vector<std::string>& input) {
+        auto g = build_graph(input);
+        return build_weighted_graph(g, aoc::csr::all_pairs_bfs(g.tunnels));
+    }
+
+    void save_graph(aoc::cache::blob_writer& out, const graph& g) {
+        out.write(g.start);
+        out.write_vector(g.flow);
+        out.write_vector(g.tunnels.offsets());
+        out.write_vector(g.tunnels.targets());
+        out.write_vector(g.tunnels.weights());
+    }
+
+    graph load_graph(aoc::cache::blob_reader& in) {
+        graph g;
+        g.start = in.read<int>();
+        g.flow = in.read_vector<int>();
+        auto offsets = in.read_vector<int>();
+        auto targets = in.read_vector<int>();
+        auto weights = in.read_vector<int>();
+        g.tunnels = aoc::csr::graph(std::move(offsets), std::move(targets), std::move(weights));
+        return g;
+    }
+
     struct traversal_state {
         uint64_t open_valves;
         int location;
@@ -189,35 +162,33 @@ namespace {
         }
     };
 
-    std::vector<edge> neighbors(const graph& g, const traversal_state& state, 
+    // the working valves; the real input has fifteen, so these fit inline
+    using edge_list = aoc::small_vector<edge, 16>;
+
+    edge_list neighbors(const graph& g, const traversal_state& state, 
             const std::vector<bool>& mask, int max_time) {
         auto u = state.location;
-        return g.verts[u].neighbors |
-            rv::remove_if(
-                [&](auto&& e)->bool {
-                    int v = e.dest;
-                    if (!mask[v]) {
-                        return true;
-                    }
-                    if (g.verts[v].flow == 0) {
-                        return true;
-                    }
-                    if (state.is_valve_open(v)) {
-                        return true;
-                    }
-                    if (state.minutes_elapsed + e.weight >= max_time) {
-                        return true;
-                    }
-                    return false;
-                }
-        ) | r::to_vector;
+        auto targets = g.tunnels.neighbors(u);
+        auto weights = g.tunnels.weights(u);
+        edge_list out;
+        for (size_t i = 0; i < targets.size(); ++i) {
+            int v = targets[i];
+            if (!mask[v] || g.flow[v] == 0 || state.is_valve_open(v)) {
+                continue;
+            }
+            if (state.minutes_elapsed + weights[i] >= max_time) {
+                continue;
+            }
+            out.push_back({ weights[i], v });
+        }
+        return out;
     }
 
     int current_flow(const graph& g, const traversal_state& state) {
         int total_flow = 0;
-        for (const auto& v : g.verts) {
-            if (state.is_valve_open(v.index)) {
-                total_flow += v.flow;
+        for (int v = 0; v < g.size(); ++v) {
+            if (state.is_valve_open(v)) {
+                total_flow += g.flow[v];
             }
         }
         return total_flow;
@@ -234,45 +205,49 @@ namespace {
         return new_state;
     }
 
-    using traversal_stack_item = std::tuple<traversal_state, edge>;
-
-    int do_traversal(const graph& g, const std::vector<bool>& mask, int max_time) {
-        std::stack<traversal_stack_item> stack;
-        traversal_state state{
-            .open_valves = 0,
-            .location = g.start,
-            .minutes_elapsed = 0,
-            .total_flow = 0
-        };
-        for (auto&& e : neighbors(g, state, mask, max_time)) {
-            stack.push({ state, e });
-        }
-        int max_flow = 0;
-        while (!stack.empty()) {
-            auto [state, e] = stack.top();
-            stack.pop();
-            //std::cout << stack.size() << " : " << max_flow << " " << state.minutes_elapsed << " " << state.open_valves << " " << state.location << "\n";
-            auto new_state = make_move(g, state, e);
-
-            if (new_state.minutes_elapsed == max_time) {
-                max_flow = std::max(max_flow, new_state.total_flow);
-                continue;
-            }
-
-            auto neigh = neighbors(g, new_state, mask, max_time);
+    class traversal_problem {
+        const graph& g_;
+        const std::vector<bool>& mask_;
+        int max_time_;
+        int max_flow_;
+    public:
+        traversal_problem(const graph& g, const std::vector<bool>& mask, int max_time) :
+            g_(g),
+            mask_(mask),
+            max_time_(max_time),
+            max_flow_(0)
+        {}
+
+        // a state with no moves left just lets its open valves run out the clock
+        void successors(const traversal_state& state, auto&& emit) {
+            auto neigh = neighbors(g_, state, mask_, max_time_);
             if (neigh.empty()) {
-                auto flow = new_state.total_flow + (max_time - new_state.minutes_elapsed) * current_flow(g, new_state);
-                max_flow = std::max(max_flow, flow);
-                continue;
+                auto flow = state.total_flow + (max_time_ - state.minutes_elapsed) * current_flow(g_, state);
+                max_flow_ = std::max(max_flow_, flow);
+                return;
             }
-            for (auto&& m : neigh) {
-                stack.push({ new_state, m });
+            for (auto&& e : neigh) {
+                emit(make_move(g_, state, e));
             }
         }
-        return max_flow;
-    }
 
-    using traversal_stack_item_with_elphant = std::tuple<traversal_state, edge, edge>;
+        int max_flow() const {
+            return max_flow_;
+        }
+    };
+
+    int do_traversal(const graph& g, const std::vector<bool>& mask, int max_time) {
+        traversal_problem problem(g, mask, max_time);
+        aoc::search::dfs(problem,
+            traversal_state{
+                .open_valves = 0,
+                .location = g.start,
+                .minutes_elapsed = 0,
+                .total_flow = 0
+            }
+        );
+        return problem.max_flow();
+    }
 
     std::vector<bool> get_mask(uint64_t bits, int start, int n) {
         std::vector<bool> mask(n, false);
@@ -302,29 +277,27 @@ namespace {
     }
     
     int do_traversal_with_elephant(const graph& g, int max_time) {
-        int n = static_cast<int>(g.verts.size());
-        uint64_t bit_mask = 0;
+        int n = g.size();
         uint64_t full_mask = (static_cast<uint64_t>(1) << (n - 1)) - 1;
 
-        int max_flow = 0;
-        for (uint64_t bits = 1; bits < full_mask; ++bits) {
-            //std::cout << bits << " : " << max_flow << "\n";
-            auto mask = get_mask(bits, g.start, n);
-            if (count_on_verts(mask) < 4) {
-                continue;
+        return aoc::parallel_transform_reduce(
+            1, static_cast<int64_t>(full_mask), 0,
+            [](int lhs, int rhs) { return std::max(lhs, rhs); },
+            [&g, n, max_time](int64_t bits)->int {
+                auto mask = get_mask(static_cast<uint64_t>(bits), g.start, n);
+                if (count_on_verts(mask) < 4) {
+                    return 0;
+                }
+                auto mask2 = invert_mask(mask, g.start);
+                auto flow1 = do_traversal(g, mask, max_time);
+                auto flow2 = do_traversal(g, mask2, max_time);
+                return flow1 + flow2;
             }
-            auto mask2 = invert_mask(mask, g.start);
-            auto flow1 = do_traversal(g, mask, max_time);
-            auto flow2 = do_traversal(g, mask2, max_time);
-            auto flow = flow1 + flow2;
-            max_flow = std::max(max_flow, flow);
-        }
-
-        return max_flow;
+        );
     }
 
     std::vector<bool> empty_mask(const graph& g) {
-        return std::vector<bool>(g.verts.size(), true);
+        return std::vector<bool>(g.size(), true);
     }
 }
 
@@ -332,12 +305,19 @@ namespace {
 
 void aoc::day_16(const std::string& title) {
     auto input = file_to_string_vector(input_path(16, 1));
-    auto g = build_graph(input);
-
-    auto tbl = shortest_path_lengths(g);
-    g = build_weighted_graph(g, tbl);
+    auto g = aoc::cache::get_or_build(
+        { "day_16_weighted_graph", 4, aoc::cache::hash_lines(input) },
+        [&input]() { return build_valve_graph(input); },
+        save_graph,
+        load_graph
+    );
+
+    auto [part_1, part_2] = aoc::parallel_invoke(
+        [&g]() { return do_traversal(g, empty_mask(g), 30); },
+        [&g]() { return do_traversal_with_elephant(g, 26); }
+    );
 
     std::cout << header(16, title);
-    std::cout << "  part 1: " << do_traversal(g, empty_mask(g), 30) << "\n";
-    std::cout << "  part 2: " << do_traversal_with_elephant(g, 26) << "\n";
+    std::cout << "  part 1: " << part_1 << "\n";
+    std::cout << "  part 2: " << part_2 << "\n";
 }
\ No newline at end of file
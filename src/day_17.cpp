@@ -1,11 +1,15 @@
 #include "util.h"
 #include "days.h"
+#include "cache.h"
+#include "checkpoint.h"
+#ifdef AOC_EMBED_INPUT
+#include "embedded_input.h"
+#endif
 #include <range/v3/all.hpp>
 #include <iostream>
 #include <functional>
 #include <array>
-#include <boost/functional/hash.hpp>
-#include <unordered_set>
+#include <algorithm>
 #include <sstream>
 
 namespace r = ranges;
@@ -38,84 +42,26 @@ namespace {
         };
     }
 
-    struct point_hash {
-        size_t operator()(const point& pt) const {
-            size_t seed = 0;
-            boost::hash_combine(seed, pt.x);
-            boost::hash_combine(seed, pt.y);
-            return seed;
-        }
-    };
-
-    using point_set = std::unordered_set<point, point_hash>;
-
     using shape_def = std::vector<point>;
 
+    // a rock as one bitmask per row, bit x set if the rock covers column x
     class shape {
-        const shape_def def_;
+        std::vector<uint8_t> rows_;
         int wd_;
-        int hgt_;
-        shape_def left_;
-        shape_def bottom_;
-        shape_def right_;
-
-        void populate_frontiers() {
-            point_set pt_set = def_ | r::to<point_set>();
-            for (auto&& pt : def_) {
-                auto  left = pt - point{ 1, 0 };
-                if (!pt_set.contains(left)) {
-                    left_.push_back(left);
-                }
-                auto right = pt + point{ 1,0 };
-                if (!pt_set.contains(right)) {
-                    right_.push_back(right);
-                }
-                auto bottom = pt - point{ 0,1 };
-                if (!pt_set.contains(bottom)) {
-                    bottom_.push_back(bottom);
-                }
-            }
-        }
 
     public:
         shape(const shape_def& def) :
-            def_(def),
-            wd_(r::max(def | rv::transform([](auto&& p) {return p.x;}))+1),
-            hgt_(r::max(def | rv::transform([](auto&& p) {return p.y; })) + 1)
+            rows_(r::max(def | rv::transform([](auto&& p) {return p.y; })) + 1, 0),
+            wd_(r::max(def | rv::transform([](auto&& p) {return p.x;}))+1)
         {
-            populate_frontiers();
-        }
-
-        auto operator()(const point& loc) const {
-            return def_ | rv::transform(
-                [&loc](auto& pt)->point {
-                    return loc + pt;
-                }
-            );
-        }
-
-        auto left(const point& loc) const {
-            return left_ | rv::transform(
-                [&loc](auto& pt)->point {
-                    return loc + pt;
-                }
-            );
+            for (auto&& pt : def) {
+                rows_[pt.y] |= static_cast<uint8_t>(1) << pt.x;
+            }
         }
 
-        auto right(const point& loc) const {
-            return right_ | rv::transform(
-                [&loc](auto& pt)->point {
-                    return loc + pt;
-                }
-            );
-        }
-
-        auto bottom(const point& loc) const {
-            return bottom_ | rv::transform(
-                [&loc](auto& pt)->point {
-                    return loc + pt;
-                }
-            );
+        // the mask of row y shifted to column x
+        uint8_t row(int y, int x) const {
+            return static_cast<uint8_t>(rows_[y] << x);
         }
 
         int width() const {
@@ -123,7 +69,7 @@ namespace {
         }
 
         int height() const {
-            return hgt_;
+            return static_cast<int>(rows_.size());
         }
     };
 
@@ -185,23 +131,32 @@ namespace {
         bool drop_shape_one_unit(const shape& shape , horz_move_stream& horz_moves, point& loc) {
             // do horz motion
             auto horz = horz_moves++;
-            if (horz < 0) {
-                if (is_empty_set(shape.left(loc))) {
-                    loc.x--;
-                }
-            } else {
-                if (is_empty_set(shape.right(loc))) {
-                    loc.x++;
-                }
+            if (fits(shape, loc + point{ horz, 0 })) {
+                loc.x += horz;
             }
             // do drop
-            if (is_empty_set(shape.bottom(loc))) {
+            if (fits(shape, loc - point{ 0, 1 })) {
                 loc.y--;
                 return true;
             }
             return false;
         }
 
+        // true if the shape at loc is inside the well and overlaps no settled rock; a whole
+        // row of the shape is tested against a row of the well at once.
+        bool fits(const shape& shape, const point& loc) const {
+            if (loc.x < 0 || loc.x + shape.width() > 7 || loc.y < 0) {
+                return false;
+            }
+            int rows = std::min(shape.height(), height() - loc.y);
+            for (int y = 0; y < rows; ++y) {
+                if (impl_[loc.y + y] & shape.row(y, loc.x)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
         void extend_height(int amt) {
             for (int i = 0; i < amt; ++i) {
                 impl_.push_back(0);
@@ -213,40 +168,26 @@ namespace {
             if (top > height()) {
                 extend_height(top - height());
             }
-            for (auto&& pt : shape(loc)) {
-                impl_[pt.y] = impl_[pt.y] | (static_cast<uint8_t>(1) << pt.x);
+            for (int y = 0; y < shape.height(); ++y) {
+                impl_[loc.y + y] |= shape.row(y, loc.x);
             }
         }
 
     public:
+        explicit well(std::vector<uint8_t> rows = {}) :
+            impl_(std::move(rows))
+        {}
+
         int height() const {
             return static_cast<int>(impl_.size());
         }
 
-        uint8_t top() const {
-            return impl_.back();
-        }
-
-        bool is_empty(const point& pt) const {
-            if (pt.x < 0 || pt.x >= 7) {
-                return false;
-            }
-            if (pt.y < 0) {
-                return false;
-            }
-            if (pt.y >= height()) {
-                return true;
-            }
-            return !(impl_[pt.y] & (static_cast<uint8_t>(1) << pt.x));
+        const std::vector<uint8_t>& rows() const {
+            return impl_;
         }
 
-        bool is_empty_set(auto pts) const {
-            for (auto&& pt : pts) {
-                if (!is_empty(pt)) {
-                    return false;
-                }
-            }
-            return true;
+        uint8_t top() const {
+            return impl_.back();
         }
 
         void drop_shape(shape_stream& shapes, horz_move_stream& horz_moves) {
@@ -281,12 +222,44 @@ namespace {
     };
 
     std::tuple<well, int, int> well_after_n_drops(const std::string& input, int n) {
-        horz_move_stream horz_moves(input);
-        shape_stream shapes;
+        aoc::checkpoint::snapshot snapshot(
+            "day_17_drops", 1, aoc::cache::hash_bytes(&n, sizeof(n), aoc::cache::hash_string(input))
+        );
+        int start = 0;
+        int shape_iter = 0;
+        int move_iter = 0;
         ::well well;
-        for (int i = 0; i < n; ++i) {
+        snapshot.restore(
+            [&](aoc::cache::blob_reader& in) {
+                auto i = in.read<int>();
+                auto shape_state = in.read<int>();
+                auto move_state = in.read<int>();
+                auto rows = in.read_vector<uint8_t>();
+                if (i < 0 || i > n || shape_state < 0 || shape_state >= 5 ||
+                        move_state < 0 || move_state >= static_cast<int>(input.size())) {
+                    throw std::runtime_error("bad day 17 checkpoint");
+                }
+                start = i;
+                shape_iter = shape_state;
+                move_iter = move_state;
+                well = ::well(std::move(rows));
+            }
+        );
+
+        horz_move_stream horz_moves(input, move_iter);
+        shape_stream shapes(shape_iter);
+        for (int i = start; i < n; ++i) {
+            snapshot.tick(
+                [&](aoc::cache::blob_writer& out) {
+                    out.write(i);
+                    out.write(shapes.state());
+                    out.write(horz_moves.state());
+                    out.write_vector(well.rows());
+                }
+            );
             well.drop_shape(shapes, horz_moves);
         }
+        snapshot.finish();
         return { std::move(well), shapes.state(), horz_moves.state() };
     }
 
@@ -318,15 +291,34 @@ namespace {
         uint64_t x = (n - k_drops_preamble) / k_drops_cycle;
         uint64_t slop = (n - k_drops_preamble) % k_drops_cycle;
 
-        const static auto tbl = make_cycle_table(input, k_drops_preamble, k_drops_cycle);
+        const uint64_t params[] = { k_drops_preamble, k_drops_cycle };
+        const static auto tbl = aoc::cache::get_or_build(
+            {
+                "day_17_cycle_table", 1,
+                aoc::cache::hash_bytes(params, sizeof(params), aoc::cache::hash_string(input))
+            },
+            [&]() { return make_cycle_table(input, k_drops_preamble, k_drops_cycle); },
+            [](aoc::cache::blob_writer& out, const std::vector<int>& tbl) { out.write_vector(tbl); },
+            [](aoc::cache::blob_reader& in) { return in.read_vector<int>(); }
+        );
 
         return k_hgt_preamble + x * k_hgt_cycle + tbl[slop];
     }
+
+#ifdef AOC_EMBED_INPUT
+    constexpr std::string_view k_embedded_jets = aoc::embedded::day_17.substr(
+        0, aoc::embedded::day_17.find_last_not_of('\n') + 1
+    );
+#endif
 }
 
 void aoc::day_17(const std::string& title) {
+#ifdef AOC_EMBED_INPUT
+    auto input = std::string(k_embedded_jets);
+#else
     auto input = file_to_string(input_path(17, 1));
     input = input | rv::take(input.size() - 1) | r::to<std::string>;
+#endif
     std::cout << header(17, title);
 
     std::cout << "  part 1: " << height_after_n_drops(input, 2022) << "\n";
@@ -1,14 +1,11 @@
 #include "util.h"
 #include "days.h"
+#include "bitplane.h"
 #include <range/v3/all.hpp>
 #include <iostream>
-#include <functional>
-#include <boost/functional/hash.hpp>
-#include <unordered_set>
 #include <array>
 #include <tuple>
 #include <limits>
-#include <stack>
 
 namespace r = ranges;
 namespace rv = ranges::views;
@@ -31,18 +28,6 @@ namespace {
         return  { lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z};
     }
 
-    struct point_hash {
-        size_t operator()(const point& pt) const {
-            size_t seed = 0;
-            boost::hash_combine(seed, pt.x);
-            boost::hash_combine(seed, pt.y);
-            boost::hash_combine(seed, pt.z);
-            return seed;
-        }
-    };
-
-    using point_set = std::unordered_set<point, point_hash>;
-
     auto strings_to_points(const std::vector<std::string>& strings) {
         return strings |
             rv::transform(
@@ -66,27 +51,6 @@ namespace {
         {0,0,-1}, // down
     } };
 
-    int surface_area(const std::vector<point>& points) {
-        auto set = points | r::to<point_set>();
-        return r::accumulate(
-            points |
-                rv::transform(
-                    [&](auto&& pt)->int {
-                        return r::accumulate(
-                            k_adjacencies |
-                                rv::transform(
-                                    [pt, &set](auto&& adjacency)->int {
-                                        return set.contains(pt + adjacency) ? 0 : 1;
-                                    }
-                                ),
-                            0
-                        );
-                    }
-                ),
-            0
-        );
-    }
-
     using cuboid = std::tuple<point, point>;
 
     cuboid bounding_volume(const std::vector<point>& points) {
@@ -104,14 +68,6 @@ namespace {
         return { min, max };
     }
 
-    int surface_area(const cuboid& c) {
-        const auto& [min, max] = c;
-        auto x = max.x - min.x + 1;
-        auto y = max.y - min.y + 1;
-        auto z = max.z - min.z + 1;
-        return 2 * (x * y) + 2 * (x * z) + 2 * (y * z);
-    }
-
     cuboid inflate(const cuboid& c) {
         const auto& [min, max] = c;
         return {
@@ -120,53 +76,48 @@ namespace {
         };
     }
 
-    bool in_cuboid(const cuboid& c, const point& pt) {
-        const auto& [min, max] = c;
-        return pt.x >= min.x && pt.x <= max.x &&
-            pt.y >= min.y && pt.y <= max.y &&
-            pt.z >= min.z && pt.z <= max.z;
+    // the droplet in a volume with a layer of air all the way around it
+    aoc::bits::volume to_volume(const std::vector<point>& points) {
+        auto [min, max] = inflate(bounding_volume(points));
+        aoc::bits::volume vol(max.x - min.x + 1, max.y - min.y + 1, max.z - min.z + 1);
+        for (const auto& pt : points) {
+            vol.set(pt.x - min.x, pt.y - min.y, pt.z - min.z);
+        }
+        return vol;
     }
 
-    std::vector<point> exterior_region(const std::vector<point>& points, const cuboid& bounds) {
-        point_set region = points | r::to<point_set>();
-        point_set visited;
-        std::stack<point> stack;
-
-        stack.push({ 0,0,0 });
-        while (!stack.empty()) {
-            auto pt = stack.top();
-            stack.pop();
-
-            if (visited.contains(pt)) {
-                continue;
-            }
-            visited.insert(pt);
-
-            auto neighbors = k_adjacencies |
-                rv::transform([&](auto&& adj) {return  pt + adj; }) |
-                rv::remove_if([&](auto&& v) {return !in_cuboid(bounds, v) || region.contains(v); });
-
-            for (const auto& neighbor : neighbors) {
-                stack.push(neighbor);
-            }
-        }
+    // the number of faces of cells in solid that touch a cell in other
+    int count_faces(const aoc::bits::volume& solid, const aoc::bits::volume& other) {
+        return r::accumulate(
+            k_adjacencies |
+                rv::transform(
+                    [&](auto&& adj)->int {
+                        return static_cast<int>(
+                            (solid & other.shifted(adj.x, adj.y, adj.z)).count()
+                        );
+                    }
+                ),
+            0
+        );
+    }
 
-        return visited | r::to_vector;
+    int surface_area(const aoc::bits::volume& lava) {
+        return count_faces(lava, ~lava);
     }
 
-    int exterior_surface_area(const std::vector<point>& points) {
-        auto bounds = inflate(bounding_volume(points));
-        auto exterior = exterior_region(points, bounds);
-        return surface_area(exterior) - surface_area(bounds);
+    int exterior_surface_area(const aoc::bits::volume& lava) {
+        aoc::bits::volume corner(lava.width(), lava.height(), lava.depth());
+        corner.set(0, 0, 0);
+        return count_faces(lava, aoc::bits::flood_fill(corner, ~lava));
     }
 }
 
 void aoc::day_18(const std::string& title) {
     auto input = file_to_string_vector(input_path(18, 1));
-    auto points = strings_to_points(input);
+    auto lava = to_volume(strings_to_points(input));
 
     std::cout << header(18, title);
 
-    std::cout << "  part 1: " << surface_area(points) << "\n";
-    std::cout << "  part 2: " << exterior_surface_area(points) << "\n";
+    std::cout << "  part 1: " << surface_area(lava) << "\n";
+    std::cout << "  part 2: " << exterior_surface_area(lava) << "\n";
 }
\ No newline at end of file
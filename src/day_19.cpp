@@ -1,15 +1,14 @@
 #include "util.h"
 #include "days.h"
+#include "search.h"
+#include "small_vector.h"
 #include <range/v3/all.hpp>
 #include <iostream>
 #include <functional>
 #include <array>
 #include <optional>
-#include <stack>
 #include <memory>
-#include <unordered_set>
 #include <sstream>
-#include <boost/functional/hash.hpp>
 #include <chrono>
 
 namespace r = ranges;
@@ -118,20 +117,6 @@ namespace {
         }
     };
 
-    struct state_hash {
-        size_t operator()(const search_state& state) const {
-            size_t seed = 0;
-            boost::hash_combine(seed, state.minute);
-            for (int i = 0; i < 4; ++i) {
-                boost::hash_combine(seed, state.num_robots[i]);
-                boost::hash_combine(seed, state.rsrc_amounts[i]);
-            }
-            return seed;
-        }
-    };
-
-    using state_set = std::unordered_set<search_state, state_hash>;
-
     using allocation = std::optional<resource>;
 
     auto resources() {
@@ -143,8 +128,11 @@ namespace {
         );
     }
 
-    std::vector<allocation> possible_actions(const blueprint& bp, const search_state& state) {
-        std::vector<allocation> allocations = { allocation{} };
+    // building nothing or one of the four robots
+    using allocation_list = aoc::small_vector<allocation, 5>;
+
+    allocation_list possible_actions(const blueprint& bp, const search_state& state) {
+        allocation_list allocations = { allocation{} };
         for (auto robot_type : resources()) {
             if (can_be_built(bp.robots[robot_type], state.rsrc_amounts)) {
                 if (robot_type == ore && state.num_robots[ore] > bp.max_cost_in_ore()) {
@@ -179,63 +167,80 @@ namespace {
         }
     }
 
-    int maximize_geodes(const blueprint& bp, int duration) {
-        std::stack<search_state> stack;
-        stack.push({});
-
-        state_set states_seen;
-        std::vector<amount_t> max_geodes_per_minute(duration, 0);
-        while (!stack.empty()) {
-            auto state = stack.top();
-            stack.pop();
-
-            if (state.minute > 0) {
-                if (states_seen.contains(state)) {
-                    continue;
-                }
-                states_seen.insert(state);
+    class geode_problem {
+        const blueprint& bp_;
+        int duration_;
+        std::vector<amount_t> max_geodes_per_minute_;
+    public:
+        geode_problem(const blueprint& bp, int duration) :
+            bp_(bp),
+            duration_(duration),
+            max_geodes_per_minute_(duration, 0)
+        {}
 
-                if (state.rsrc_amounts[geode] < max_geodes_per_minute[state.minute - 1] - 1) {
-                    continue;
-                }
-                max_geodes_per_minute[state.minute - 1] = std::max(state.rsrc_amounts[geode], max_geodes_per_minute[state.minute - 1]);
-                if (state.minute == duration) {
-                    continue;
-                }
+        // 6 bits of minute, 6 bits per robot count and 8 bits per resource amount. robot
+        // counts never exceed the duration + 1, so this is exact for durations under 63.
+        uint64_t key(const search_state& state) const {
+            uint64_t key = static_cast<uint64_t>(state.minute);
+            for (int i = 0; i < 4; ++i) {
+                key = (key << 6) | state.num_robots[i];
+                key = (key << 8) | state.rsrc_amounts[i];
             }
+            return key;
+        }
 
-            std::vector<allocation> actions = possible_actions(bp, state);
-            auto next_states = actions | rv::transform(
-                [&bp, &state](auto&& a)->search_state {
-                    auto allocated = perform_allocation(bp, state, a);
-                    do_production(allocated);
-                    allocated.minute++;
+        bool prune(const search_state& state) {
+            if (state.minute == 0) {
+                return false;
+            }
+            auto& max_geodes = max_geodes_per_minute_[state.minute - 1];
+            if (state.rsrc_amounts[geode] < max_geodes - 1) {
+                return true;
+            }
+            max_geodes = std::max(state.rsrc_amounts[geode], max_geodes);
+            return state.minute == duration_;
+        }
 
-                    return allocated;
-                }
-            );
-            for (auto&& next_state : next_states) {
-                stack.push(next_state);
+        void successors(const search_state& state, auto&& emit) const {
+            for (auto&& a : possible_actions(bp_, state)) {
+                auto allocated = perform_allocation(bp_, state, a);
+                do_production(allocated);
+                allocated.minute++;
+                emit(allocated);
             }
         }
 
-        return max_geodes_per_minute[duration - 1];
+        int max_geodes() const {
+            return max_geodes_per_minute_[duration_ - 1];
+        }
+    };
+
+    int maximize_geodes(const blueprint& bp, int duration) {
+        if (duration >= 63) {
+            throw std::runtime_error("duration too long for the packed search state");
+        }
+        geode_problem problem(bp, duration);
+        aoc::search::dfs(problem, search_state{});
+        return problem.max_geodes();
     }
 
     int sum_of_quality_level(const std::vector<blueprint>& blueprints, int minute) {
-        int sum = 0;
-        int i = 0;
-        for (const auto& blueprint : blueprints) {
-            int geodes = maximize_geodes(blueprint, minute);
-            sum += blueprint.id * geodes;
-        }
-        return sum;
+        return aoc::parallel_transform_reduce(
+            0, static_cast<int64_t>(blueprints.size()), 0, std::plus<int>(),
+            [&blueprints, minute](int64_t i)->int {
+                const auto& blueprint = blueprints[i];
+                return blueprint.id * maximize_geodes(blueprint, minute);
+            }
+        );
     }
 
-    int product_of_max_geodes(const std::array<blueprint, 3> blueprints, int minute) {
-        return maximize_geodes(blueprints[0], minute) *
-            maximize_geodes(blueprints[1], minute) *
-            maximize_geodes(blueprints[2], minute);
+    int product_of_max_geodes(const std::array<blueprint, 3>& blueprints, int minute) {
+        return aoc::parallel_transform_reduce(
+            0, static_cast<int64_t>(blueprints.size()), 1, std::multiplies<int>(),
+            [&blueprints, minute](int64_t i)->int {
+                return maximize_geodes(blueprints[i], minute);
+            }
+        );
     }
 }
 
@@ -245,11 +250,15 @@ void aoc::day_19(const std::string& title) {
 
     auto t1 =  ch::high_resolution_clock::now();
     
-    std::cout << header(19, title);
-    std::cout << "  part 1: " << sum_of_quality_level(blueprints, 24) << "\n";
-
     std::array<blueprint, 3> ary = { blueprints[0], blueprints[1], blueprints[2] };
-    std::cout << "  part 2: " << product_of_max_geodes(ary, 32)  << "\n";
+    auto [part_1, part_2] = aoc::parallel_invoke(
+        [&blueprints]() { return sum_of_quality_level(blueprints, 24); },
+        [&ary]() { return product_of_max_geodes(ary, 32); }
+    );
+
+    std::cout << header(19, title);
+    std::cout << "  part 1: " << part_1 << "\n";
+    std::cout << "  part 2: " << part_2  << "\n";
 
     auto dur = ch::duration_cast<ch::seconds>(ch::high_resolution_clock::now() - t1);
     std::cout << "time: " << dur.count() << " sec.";
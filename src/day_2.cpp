@@ -1,106 +1,284 @@
 #include "util.h"
 #include "days.h"
-#include <range/v3/all.hpp>
+#include "simd.h"
+#ifdef AOC_EMBED_INPUT
+#include "embedded_input.h"
+#endif
 #include <vector>
 #include <string>
 #include <iostream>
-#include <unordered_map>
 #include <array>
 #include <tuple>
-
-namespace r = ranges;
-namespace rv = ranges::views;
+#include <string_view>
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
 
 /*------------------------------------------------------------------------------------------------*/
 
 namespace {
-    namespace rps {
-        enum class shape : int {
-            rock = 0, paper = 1, scissors = 2
-        }; 
-
-        enum class outcome : int {
-            loss = 0, draw = 1, win = 2
-        };
+
+    enum class outcome : int {
+        loss = 0, draw = 1, win = 2
+    };
+
+    // rock paper scissors generalised to an odd number N of shapes set in a cycle, where each
+    // shape beats the shapes an odd number of steps behind it and loses to the rest, so 3 is the
+    // usual game and 5 is rock paper scissors lizard spock. the opponent's shapes are lettered
+    // from 'A' and the second column's up to 'Z', so that for 3 shapes they are A-C and X-Z.
+    template <int N>
+    constexpr bool is_cyclic_game = N >= 3 && N <= 7 && N % 2 == 1;
+
+    template <int N>
+    constexpr char k_first_column_letter = 'Z' - (N - 1);
+
+    template <int N>
+    constexpr auto win_loss_matrix = [] {
+        static_assert(is_cyclic_game<N>);
+        std::array<std::array<outcome, N>, N> matrix = {};
+        for (int p1 = 0; p1 < N; ++p1) {
+            for (int p2 = 0; p2 < N; ++p2) {
+                auto steps = (p1 - p2 + N) % N;
+                matrix[p1][p2] = (steps == 0) ? outcome::draw :
+                    (steps % 2 == 1) ? outcome::win : outcome::loss;
+            }
+        }
+        return matrix;
+    }();
+
+    // for part 2 the second column is the number of steps from the opponent's shape to player
+    // 1's, centred on zero: X, Y and Z of the usual game are one behind (lose), level (draw)
+    // and one ahead (win)
+    template <int N>
+    constexpr auto yield_outcome_matrix = [] {
+        static_assert(is_cyclic_game<N>);
+        std::array<std::array<int, N>, N> matrix = {};
+        for (int column = 0; column < N; ++column) {
+            for (int p2 = 0; p2 < N; ++p2) {
+                matrix[column][p2] = (p2 + column - (N - 1) / 2 + N) % N;
+            }
+        }
+        return matrix;
+    }();
+
+    template <int N>
+    constexpr int score_match(int p1, int p2) {
+        // (score for player 1's shape + 1) + 3 * (score for outcome);
+        return (p1 + 1) + 3 * static_cast<int>(win_loss_matrix<N>[p1][p2]);
     }
 
-    rps::shape letter_to_shape(char letter) {
-        const static std::unordered_map<char, rps::shape> map_letter_to_shape = {
-            {'A', rps::shape::rock}, {'B', rps::shape::paper}, {'C', rps::shape::scissors},
-            {'X', rps::shape::rock}, {'Y', rps::shape::paper}, {'Z', rps::shape::scissors}
-        };
-        return map_letter_to_shape.at(letter);
+    // a round as a small key made of the low bits of its two letters, which tell all of the
+    // letters of a column apart: two bits each for 3 shapes, so that the key is a nibble, and
+    // three each for up to 7
+    template <int N>
+    constexpr int k_key_bits = (N <= 3) ? 2 : 3;
+
+    template <int N>
+    constexpr int round_key(char opponent, char column) {
+        constexpr int mask = (1 << k_key_bits<N>) - 1;
+        return ((opponent & mask) << k_key_bits<N>) | (column & mask);
     }
 
-    rps::outcome player1_vs_player2_outcome(rps::shape p1, rps::shape p2) {
-        const static std::array<std::array<rps::outcome, 3>, 3> win_loss_matrix = {{
-            {rps::outcome::draw, rps::outcome::loss, rps::outcome::win},
-            {rps::outcome::win, rps::outcome::draw, rps::outcome::loss},
-            {rps::outcome::loss, rps::outcome::win, rps::outcome::draw}
-        }};
-        return win_loss_matrix[static_cast<int>(p1)][static_cast<int>(p2)];
+    // whether the letters are the opponent's and player 1's of the game; the keys of any others
+    // may alias real rounds, so they are rejected before scoring
+    template <int N>
+    constexpr bool is_round(char opponent, char column) {
+        return (static_cast<unsigned char>(opponent - 'A') < N) &
+            (static_cast<unsigned char>(column - k_first_column_letter<N>) < N);
     }
 
-    int score_match(rps::shape p1, rps::shape p2) {
-        auto outcome = player1_vs_player2_outcome(p1, p2);
-        // (score for player 1's shape + 1) + 3 * (score for outcome);
-        return (static_cast<int>(p1)+1) + 3*static_cast<int>(outcome);
+    template <int N>
+    bool are_rounds(const char* data, size_t records) {
+        bool valid = true;
+        for (size_t i = 0; i < records; ++i) {
+            valid &= is_round<N>(data[4 * i], data[4 * i + 2]);
+        }
+        return valid;
+    }
+
+    void throw_bad_round() {
+        throw std::runtime_error("day 2: a round must be two letters of the game");
+    }
+
+    template <int N>
+    using score_table = std::array<uint8_t, 1 << (2 * k_key_bits<N>)>;
+
+    // the score of every possible round by key, reading the second column as player 1's shape
+    // for part 1 and as steps from the opponent's shape for part 2
+    template <int N>
+    constexpr score_table<N> make_score_table(bool column_is_steps) {
+        score_table<N> tbl = {};
+        for (int p2 = 0; p2 < N; ++p2) {
+            for (int column = 0; column < N; ++column) {
+                auto p1 = column_is_steps ? yield_outcome_matrix<N>[column][p2] : column;
+                auto key = round_key<N>(
+                    static_cast<char>('A' + p2), static_cast<char>(k_first_column_letter<N> + column)
+                );
+                tbl[key] = static_cast<uint8_t>(score_match<N>(p1, p2));
+            }
+        }
+        return tbl;
     }
 
-    std::tuple<rps::shape, rps::shape> parse_input_line_1(const std::string& inp_line) {
-        auto p1_char = inp_line[2];
-        auto p2_char = inp_line[0];
-        return { letter_to_shape(p1_char), letter_to_shape(p2_char) };
+    template <int N>
+    constexpr auto k_part_1_scores = make_score_table<N>(false);
+
+    template <int N>
+    constexpr auto k_part_2_scores = make_score_table<N>(true);
+
+    // both parts' scores in one word, part 1 in the low half, so that a round costs one load and
+    // one add
+    template <int N>
+    constexpr auto k_combined_scores = [] {
+        std::array<uint64_t, std::tuple_size_v<score_table<N>>> tbl = {};
+        for (size_t key = 0; key < tbl.size(); ++key) {
+            tbl[key] = k_part_1_scores<N>[key] | (static_cast<uint64_t>(k_part_2_scores<N>[key]) << 32);
+        }
+        return tbl;
+    }();
+
+    // a round scores at most 7 + 6, so the low half of a combined sum cannot carry into the high
+    // half within this many rounds
+    constexpr size_t k_rounds_per_block = size_t{ 1 } << 24;
+
+    // the totals of records of four bytes, "A X\n". the usual game's tables are nibble tables,
+    // which the simd kernel looks up sixteen rounds at a time; the larger games are summed from
+    // the combined table without a branch per round.
+    template <int N>
+    std::tuple<int64_t, int64_t> score_records(const char* data, size_t records) {
+        if constexpr (N == 3) {
+            auto [sum1, sum2] = aoc::simd::sum_record_lookups(
+                data, records, k_part_1_scores<N>, k_part_2_scores<N>
+            );
+            return { static_cast<int64_t>(sum1), static_cast<int64_t>(sum2) };
+        } else {
+            int64_t part1 = 0;
+            int64_t part2 = 0;
+            for (size_t block = 0; block < records; block += k_rounds_per_block) {
+                auto block_end = std::min(records, block + k_rounds_per_block);
+                uint64_t sums = 0;
+                for (size_t i = block; i < block_end; ++i) {
+                    sums += k_combined_scores<N>[round_key<N>(data[4 * i], data[4 * i + 2])];
+                }
+                part1 += static_cast<int64_t>(sums & 0xffffffff);
+                part2 += static_cast<int64_t>(sums >> 32);
+            }
+            return { part1, part2 };
+        }
     }
 
-    // part 2...
-    rps::outcome letter_to_outcome(char letter) {
-        const static std::unordered_map<char, rps::outcome> map_letter_to_outcome = {
-            {'X', rps::outcome::loss}, {'Y', rps::outcome::draw}, {'Z', rps::outcome::win}
-        };
-        return map_letter_to_outcome.at(letter);
+    // true if every fourth byte, and no other, is a line break in these whole 64-byte blocks, so
+    // that they are all records "A X\n". a longer or shorter line anywhere, such as one ending in
+    // CRLF, would put the records out of step.
+    bool is_fixed_width(const char* data, size_t n) {
+        constexpr uint64_t k_record_ends = 0x8888888888888888;
+        for (size_t i = 0; i < n; i += 64) {
+            if (aoc::simd::match_mask_64(data + i, '\n') != k_record_ends) {
+                return false;
+            }
+        }
+        return true;
     }
 
-    std::tuple<rps::outcome, rps::shape> parse_input_line_2(const std::string& inp_line) {
-        auto p2_char = inp_line[0];
-        auto outcome_char = inp_line[2];
-        return { letter_to_outcome(outcome_char), letter_to_shape(p2_char) };
+    // the records are checked and scored a chunk at a time, small enough to still be in cache
+    // when it is scored, so that the text is only read from memory once
+    constexpr size_t k_chunk_bytes = 16 * 1024;
+
+    // both totals from the raw text. rounds are normally exactly "A X\n", which once their line
+    // breaks are seen to be in step are scored as fixed-width records; from the first chunk that
+    // is not, such as with CRLF line ends, and for a tail of less than a block, the rest is
+    // scored line by line from the same tables.
+    template <int N>
+    std::tuple<int64_t, int64_t> score_rounds(const char* data, size_t n) {
+        int64_t part1 = 0;
+        int64_t part2 = 0;
+        const char* end = data + n;
+        while (end - data >= 64) {
+            auto bytes = std::min<size_t>(end - data, k_chunk_bytes) & ~size_t{ 63 };
+            if (!is_fixed_width(data, bytes)) {
+                break;
+            }
+            if (!are_rounds<N>(data, bytes / 4)) {
+                throw_bad_round();
+            }
+            auto [chunk1, chunk2] = score_records<N>(data, bytes / 4);
+            part1 += chunk1;
+            part2 += chunk2;
+            data += bytes;
+        }
+
+        while (data < end) {
+            auto len = aoc::simd::find_byte(data, end - data, '\n');
+            if (len >= 3) {
+                if (!is_round<N>(data[0], data[2])) {
+                    throw_bad_round();
+                }
+                auto scores = k_combined_scores<N>[round_key<N>(data[0], data[2])];
+                part1 += static_cast<int64_t>(scores & 0xffffffff);
+                part2 += static_cast<int64_t>(scores >> 32);
+            }
+            if (data + len == end) {
+                break;
+            }
+            data += len + 1;
+        }
+        return { part1, part2 };
     }
 
-    rps::shape shape_to_yield_outcome(rps::shape player_2, rps::outcome desired_outcome) {
-        const static std::array<std::array<rps::shape, 3>, 3> yield_outcome_matrix = {{
-            {rps::shape::scissors, rps::shape::rock, rps::shape::paper},
-            {rps::shape::rock, rps::shape::paper, rps::shape::scissors},
-            {rps::shape::paper, rps::shape::scissors, rps::shape::rock }
-        }};
-        return yield_outcome_matrix[static_cast<int>(desired_outcome)][static_cast<int>(player_2)];
+    // the usual game unless AOC_DAY_2_SHAPES asks for one of the larger ones
+    int shape_count() {
+        const char* shapes = std::getenv("AOC_DAY_2_SHAPES");
+        return (shapes && *shapes) ? std::atoi(shapes) : 3;
     }
+
+    std::tuple<int64_t, int64_t> score_rounds(int shapes, const char* data, size_t n) {
+        switch (shapes) {
+            case 3:
+                return score_rounds<3>(data, n);
+            case 5:
+                return score_rounds<5>(data, n);
+            case 7:
+                return score_rounds<7>(data, n);
+        }
+        throw std::runtime_error("day 2: the game must have 3, 5 or 7 shapes");
+    }
+
+#ifdef AOC_EMBED_INPUT
+    // both totals, computed by the compiler from the embedded input. lines are "A X\n".
+    constexpr std::tuple<int64_t, int64_t> total_scores(std::string_view input) {
+        int64_t part1 = 0;
+        int64_t part2 = 0;
+        size_t i = 0;
+        while (i + 2 < input.size()) {
+            if (!is_round<3>(input[i], input[i + 2])) {
+                // reached only for a bad embedded input, which then fails to compile
+                throw std::runtime_error("day 2: a round must be two letters of the game");
+            }
+            auto key = round_key<3>(input[i], input[i + 2]);
+            part1 += k_part_1_scores<3>[key];
+            part2 += k_part_2_scores<3>[key];
+            i = input.find('\n', i);
+            if (i == std::string_view::npos) {
+                break;
+            }
+            ++i;
+        }
+        return { part1, part2 };
+    }
+
+    constexpr auto k_embedded_scores = total_scores(aoc::embedded::day_2);
+#endif
 }
 
 void aoc::day_2(const std::string& title) {
-    auto input = file_to_string_vector(input_path(2, 1));
-    auto total_score_part1 = r::accumulate(
-        input |
-            rv::transform(
-                [](const auto& inp_line)->int {
-                    auto [p1_shape, p2_shape] = parse_input_line_1(inp_line);
-                    return score_match(p1_shape, p2_shape);
-                }
-            ),
-        0
-    );
-
-    auto total_score_part2 = r::accumulate(
-        input |
-            rv::transform(
-                [](const auto& inp_line)->int {
-                    auto [desired_outcome, p2_shape] = parse_input_line_2(inp_line);
-                    auto p1_shape = shape_to_yield_outcome(p2_shape, desired_outcome);
-                    return score_match(p1_shape, p2_shape);
-                }
-            ),
-        0
-    );
+    auto shapes = shape_count();
+#ifdef AOC_EMBED_INPUT
+    auto [total_score_part1, total_score_part2] = (shapes == 3) ? k_embedded_scores :
+        score_rounds(shapes, aoc::embedded::day_2.data(), aoc::embedded::day_2.size());
+#else
+    aoc::mapped_file input(input_path(2, 1));
+    auto [total_score_part1, total_score_part2] = score_rounds(shapes, input.data(), input.size());
+#endif
 
     std::cout << header(2, title);
     std::cout << "  part 1: " << total_score_part1 << "\n";
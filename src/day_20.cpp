@@ -1,5 +1,6 @@
 #include "util.h"
 #include "days.h"
+#include "checkpoint.h"
 #include <range/v3/all.hpp>
 #include <iostream>
 #include <functional>
@@ -53,6 +54,39 @@ namespace {
             return static_cast<int>(nodes_.size());
         }
 
+        // the index of the node after each node
+        std::vector<int> order() const {
+            return nodes_ |
+                rv::transform(
+                    [this](const auto& node) {
+                        return static_cast<int>(node.next_ - nodes_.data());
+                    }
+                ) | r::to_vector;
+        }
+
+        void set_order(const std::vector<int>& next) {
+            if (next.size() != nodes_.size()) {
+                throw std::runtime_error("mix_list: bad order");
+            }
+            // next must link all of the nodes into a single cycle
+            std::vector<bool> seen(next.size(), false);
+            int i = 0;
+            for (int k = 0; k < length(); ++k) {
+                if (seen[i] || next[i] < 0 || next[i] >= length()) {
+                    throw std::runtime_error("mix_list: bad order");
+                }
+                seen[i] = true;
+                i = next[i];
+            }
+            if (i != 0) {
+                throw std::runtime_error("mix_list: bad order");
+            }
+            for (int j = 0; j < length(); ++j) {
+                nodes_[j].next_ = &nodes_[next[j]];
+                nodes_[next[j]].prev_ = &nodes_[j];
+            }
+        }
+
         void mix(int i) {
             auto n = length();
             auto distance = nodes_[i].value % static_cast<int64_t>(n-1);
@@ -80,13 +114,34 @@ namespace {
     };
 
     int64_t mix(const std::vector<int64_t>& numbers, int n) {
-
+        aoc::checkpoint::snapshot snapshot(
+            "day_20_mix", 1,
+            aoc::cache::hash_bytes(numbers.data(), numbers.size() * sizeof(int64_t), n)
+        );
         mix_list list(numbers);
-        for (int j = 0; j < n; ++j) {
-            for (int i = 0; i < list.length(); ++i) {
-                list.mix(i);
+        int start = 0;
+        snapshot.restore(
+            [&](aoc::cache::blob_reader& in) {
+                auto step = in.read<int>();
+                if (step < 0 || step > n * list.length()) {
+                    throw std::runtime_error("bad day 20 checkpoint");
+                }
+                list.set_order(in.read_vector<int>());
+                start = step;
             }
+        );
+
+        // step k of the mix moves number k % length in round k / length
+        for (int step = start; step < n * list.length(); ++step) {
+            snapshot.tick(
+                [&](aoc::cache::blob_writer& out) {
+                    out.write(step);
+                    out.write_vector(list.order());
+                }
+            );
+            list.mix(step % list.length());
         }
+        snapshot.finish();
 
         auto vec = list.values() | r::to_vector;
         std::array<int64_t, 3> indices = { {1000,2000,3000} };
@@ -115,7 +170,12 @@ void aoc::day_20(const std::string& title) {
             [](auto v)->int64_t { return v * 811589153; }
         ) | r::to_vector;
 
+    auto [part_1, part_2] = aoc::parallel_invoke(
+        [&part1_input]() { return mix(part1_input, 1); },
+        [&part2_input]() { return mix(part2_input, 10); }
+    );
+
     std::cout << header(20, title);
-    std::cout << "  part 1: " << mix(part1_input, 1) << "\n";
-    std::cout << "  part 2: " << mix(part2_input, 10) << "\n";
+    std::cout << "  part 1: " << part_1 << "\n";
+    std::cout << "  part 2: " << part_2 << "\n";
 }
\ No newline at end of file
@@ -1,12 +1,14 @@
 #include "util.h"
 #include "days.h"
+#include "interner.h"
+#include "csr_graph.h"
 #include <range/v3/all.hpp>
 #include <iostream>
-#include <functional>
+#include <array>
 #include <variant>
 #include <sstream>
-#include <unordered_map>
-#include <stack>
+#include <optional>
+#include <vector>
 
 namespace r = ranges;
 namespace rv = ranges::views;
@@ -15,157 +17,162 @@ namespace rv = ranges::views;
 
 namespace {
 
+    // variables are referred to by their interned names
     struct binary_expression {
         char op;
-        std::string lhs;
-        std::string rhs;
+        int lhs;
+        int rhs;
     };
     using expression = std::variant<int64_t, binary_expression>;
     struct variable_def {
-        std::string var;
+        int var;
         expression expr;
     };
-    using var_def_tbl = std::unordered_map<std::string, expression>;
 
-    variable_def str_to_variable_def(const std::string& line) {
+    // indexed by variable; empty where a variable has no definition
+    using var_def_tbl = std::vector<std::optional<expression>>;
+
+    using binary_op = int64_t(*)(int64_t, int64_t);
+
+    constexpr auto op_tbl = [] {
+        std::array<binary_op, 256> tbl = {};
+        tbl['+'] = [](int64_t lhs, int64_t rhs)->int64_t { return lhs + rhs; };
+        tbl['-'] = [](int64_t lhs, int64_t rhs)->int64_t { return lhs - rhs; };
+        tbl['*'] = [](int64_t lhs, int64_t rhs)->int64_t { return lhs * rhs; };
+        tbl['/'] = [](int64_t lhs, int64_t rhs)->int64_t { return lhs / rhs; };
+        return tbl;
+    }();
+
+    variable_def str_to_variable_def(const std::string& line, aoc::interner& names) {
         auto [var, def] = aoc::split_to_tuple<2>(line, ':');
         def = aoc::trim(def);
         if (aoc::is_number(def)) {
-            return { var, std::stoi(def) };
+            return { names.intern(var), std::stoi(def) };
         }
         auto [lhs, op, rhs] = aoc::split_to_tuple<3>(def, ' ');
-        return { var, {binary_expression{op[0], lhs, rhs}} };
+        if (op.size() != 1 || !op_tbl[static_cast<unsigned char>(op[0])]) {
+            throw std::runtime_error("unknown operator: " + op);
+        }
+        auto var_id = names.intern(var);
+        auto lhs_id = names.intern(lhs);
+        auto rhs_id = names.intern(rhs);
+        return { var_id, {binary_expression{op[0], lhs_id, rhs_id}} };
     }
 
-    std::optional<int64_t> maybe_evaluate_variable(const var_def_tbl& defs, const std::string& var){
-        const static std::unordered_map<char, std::function<int64_t(int64_t, int64_t)>> op_tbl = {
-            {'+', [](int64_t lhs, int64_t rhs)->int64_t { return lhs + rhs; }},
-            {'-', [](int64_t lhs, int64_t rhs)->int64_t { return lhs - rhs; }},
-            {'*', [](int64_t lhs, int64_t rhs)->int64_t { return lhs * rhs; }},
-            {'/', [](int64_t lhs, int64_t rhs)->int64_t { return lhs / rhs; }}
-        };
-        std::stack<int64_t> arg_stack;
-        std::stack<std::string> eval_stack;
-        eval_stack.push({ var });
-        while (!eval_stack.empty()) {
-            auto item = eval_stack.top();
-            eval_stack.pop();
-            if (item.size() == 1) {
-                auto func = op_tbl.at(item.front());
-                auto arg1 = arg_stack.top();
-                arg_stack.pop();
-                auto arg2 = arg_stack.top();
-                arg_stack.pop();
-                arg_stack.push(func(arg1, arg2));
-            } else {
-                if (!defs.contains(item)) {
-                    return {};
-                }
-                auto val = defs.at(item);
-                if (std::holds_alternative<int64_t>(val)) {
-                    arg_stack.push(std::get<int64_t>(val));
-                } else {
-                    auto expr = std::get<binary_expression>(val);
-                    eval_stack.push(std::string(1,expr.op));
-                    eval_stack.push(expr.lhs);
-                    eval_stack.push(expr.rhs);
+    // the dependency dag: an edge from each variable to each of its operands. every operand
+    // must itself be defined, so that evaluation never reads an empty table entry.
+    aoc::csr::graph dependency_graph(const var_def_tbl& defs, const aoc::interner& names) {
+        std::vector<aoc::csr::edge> edges;
+        for (int var = 0; var < static_cast<int>(defs.size()); ++var) {
+            if (defs[var] && std::holds_alternative<binary_expression>(*defs[var])) {
+                const auto& expr = std::get<binary_expression>(*defs[var]);
+                for (int operand : { expr.lhs, expr.rhs }) {
+                    if (!defs[operand]) {
+                        throw std::runtime_error("undefined variable: " + names.name(operand));
+                    }
+                    edges.push_back({ var, operand });
                 }
             }
         }
-        return arg_stack.top();
+        return aoc::csr::graph(static_cast<int>(defs.size()), edges);
     }
 
-    int64_t evaluate_variable(const var_def_tbl& defs, const std::string& var) {
-        auto result = maybe_evaluate_variable(defs, var);
-        return result.value();
+    // the variables, each after its operands
+    std::vector<int> evaluation_order(const aoc::csr::graph& deps) {
+        auto order = aoc::csr::topological_order(deps);
+        if (!order) {
+            throw std::runtime_error("the variable definitions are cyclic");
+        }
+        return *order | rv::reverse | r::to_vector;
     }
 
-    std::optional<variable_def> find_unknown_expression(
-            const var_def_tbl& definitions, const std::string& variable) {
-        for (const auto& var_def : definitions ) {
-            const auto [var, expr] = var_def;
-            if (std::holds_alternative<binary_expression>(expr)) {
-                const auto& bin_expr = std::get<binary_expression>(expr);
-                if (bin_expr.lhs == variable || bin_expr.rhs == variable) {
-                    return { { var, bin_expr } };
-                }
+    // the value of every variable
+    std::vector<int64_t> evaluate_all(const var_def_tbl& defs, const std::vector<int>& order) {
+        std::vector<int64_t> values(defs.size(), 0);
+        for (int var : order) {
+            const auto& def = *defs[var];
+            if (std::holds_alternative<int64_t>(def)) {
+                values[var] = std::get<int64_t>(def);
+            } else {
+                const auto& expr = std::get<binary_expression>(def);
+                auto func = op_tbl[static_cast<unsigned char>(expr.op)];
+                values[var] = func(values[expr.lhs], values[expr.rhs]);
             }
         }
-        return {};
-    }
-
-    variable_def root_definition(const var_def_tbl& definitions, const std::string unknown) {
-        auto root_expr = std::get<binary_expression>(definitions.at("root"));
-        auto defs = definitions;
-        defs.erase(unknown);
-        auto lhs = maybe_evaluate_variable(defs, root_expr.lhs);
-        auto rhs = maybe_evaluate_variable(defs, root_expr.rhs);
-        return (lhs) ? variable_def{ root_expr.rhs, *lhs } : variable_def{ root_expr.lhs, *rhs };
+        return values;
     }
 
-    std::vector<variable_def> solve_for_x(const variable_def& def, std::string unknown,
-            const var_def_tbl& defs) {
-        const auto& expr = std::get<binary_expression>(def.expr);
-        bool unknown_on_left = (expr.lhs == unknown);
-        auto old_var = def.var;
-        auto arg_var = unknown_on_left ? expr.rhs : expr.lhs;
-        auto arg_value = evaluate_variable(defs, arg_var);
-        std::string key = std::string(1, expr.op) + ((unknown_on_left) ? "L" : "R");
-        std::unordered_map<std::string, binary_expression> inverse_op = {
-            {"-L", { '+', old_var, arg_var} } , {"+L", { '-', old_var, arg_var} },
-            {"-R", { '-', arg_var, old_var} } , {"+R", { '-', old_var, arg_var} },
-            {"/L", { '*', old_var, arg_var} } , {"*L", { '/', old_var, arg_var} },
-            {"/R", { '/', arg_var, old_var} } , {"*R", { '/', old_var, arg_var} }
-        };
-        return {
-            variable_def{arg_var, arg_value},
-            variable_def{unknown, inverse_op.at(key) }
-        };
-    }
+    // the operation that isolates the unknown operand of "old = a op b", and whether the
+    // known argument comes first in it. indexed by [op][unknown is the left operand].
+    struct inverse_op {
+        char op;
+        bool arg_first;
+    };
 
-    int64_t solve_for_unknown(const var_def_tbl& defs, const std::string& unknown) {
-
-        var_def_tbl solve_for_humn_tbl;
-        auto root_def = root_definition(defs, unknown);
-        solve_for_humn_tbl[root_def.var] = root_def.expr;
-        auto definitions = defs;
-        definitions.erase("root");
-        
-        std::string unknown_var = unknown;
-        while (!unknown_var.empty()) {
-            auto unknown_expr = find_unknown_expression(definitions, unknown_var);
-            if (!unknown_expr) {
-                if (unknown_var == root_def.var) {
-                    unknown_var = {};
-                    continue;
-                }
+    constexpr auto inverse_op_tbl = [] {
+        std::array<std::array<inverse_op, 2>, 256> tbl = {};
+        tbl['+'] = { { {'-', false}, {'-', false} } };
+        tbl['-'] = { { {'-', true},  {'+', false} } };
+        tbl['*'] = { { {'/', false}, {'/', false} } };
+        tbl['/'] = { { {'/', true},  {'*', false} } };
+        return tbl;
+    }();
+
+    // walks from root down to the unknown along the variables that depend on it, inverting one
+    // operation per step; every other operand already has its value.
+    int64_t solve_for_unknown(const var_def_tbl& defs, const aoc::csr::graph& deps,
+            const std::vector<int>& order, const std::vector<int64_t>& values,
+            int root, int unknown) {
+        std::vector<char> depends_on_unknown(defs.size(), 0);
+        depends_on_unknown[unknown] = 1;
+        aoc::csr::aggregate(deps, order, depends_on_unknown,
+            [](char lhs, char rhs)->char { return lhs || rhs; }
+        );
+
+        auto root_expr = std::get<binary_expression>(*defs[root]);
+        bool unknown_on_left = depends_on_unknown[root_expr.lhs];
+        int var = unknown_on_left ? root_expr.lhs : root_expr.rhs;
+        int64_t target = values[unknown_on_left ? root_expr.rhs : root_expr.lhs];
+        while (var != unknown) {
+            const auto& expr = std::get<binary_expression>(*defs[var]);
+            if (depends_on_unknown[expr.lhs] && depends_on_unknown[expr.rhs]) {
                 throw std::runtime_error(
                     "this algorithm in not sophisticated enough to solve this input"
                 );
             }
-            const auto [var, expr] = *unknown_expr;
-            auto new_expressions = solve_for_x({ var,expr }, unknown_var, definitions);
-            for (const auto& new_expr : new_expressions) {
-                solve_for_humn_tbl[new_expr.var] = new_expr.expr;
-            }
-            unknown_var = var;
+            unknown_on_left = depends_on_unknown[expr.lhs];
+            auto arg_value = values[unknown_on_left ? expr.rhs : expr.lhs];
+            auto inverse = inverse_op_tbl[static_cast<unsigned char>(expr.op)][unknown_on_left];
+            auto func = op_tbl[static_cast<unsigned char>(inverse.op)];
+            target = inverse.arg_first ? func(arg_value, target) : func(target, arg_value);
+            var = unknown_on_left ? expr.lhs : expr.rhs;
         }
-
-        return evaluate_variable(solve_for_humn_tbl, unknown);
+        return target;
     }
 }
 
 void aoc::day_21(const std::string& title) {
     auto input = file_to_string_vector(input_path(21, 1));
-    auto variable_defs = input | rv::transform(str_to_variable_def) |
-            rv::transform(
-                [](const variable_def& def)->var_def_tbl::value_type {
-                    return { def.var,  def.expr };
-                }
-        ) | r::to<var_def_tbl>();
+    aoc::interner names;
+    auto defs = input |
+        rv::transform(
+            [&names](const std::string& line) {
+                return str_to_variable_def(line, names);
+            }
+        ) | r::to_vector;
+    var_def_tbl variable_defs(names.size());
+    for (const auto& def : defs) {
+        variable_defs[def.var] = def.expr;
+    }
+    auto root = names.id("root");
+    auto humn = names.id("humn");
+
+    auto deps = dependency_graph(variable_defs, names);
+    auto order = evaluation_order(deps);
+    auto values = evaluate_all(variable_defs, order);
 
     std::cout << header(21, title);
 
-    std::cout << "  part 1: " << evaluate_variable(variable_defs, "root") << "\n";
-    std::cout << "  part 2: " << solve_for_unknown(variable_defs, "humn") << "\n";
+    std::cout << "  part 1: " << values[root] << "\n";
+    std::cout << "  part 2: " << solve_for_unknown(variable_defs, deps, order, values, root, humn) << "\n";
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "util.h"
 #include "days.h"
+#include "grid.h"
 #include <range/v3/all.hpp>
 #include <iostream>
 #include <functional>
@@ -430,11 +431,12 @@ namespace {
         return chars[n % 62];
     }
 
+    // Dim is the side of a face when it is known at compile time, or aoc::dynamic_extent
+    template <int Dim>
     class cube_grid {
-        std::array<std::vector<std::vector<char>>, 6> faces_;
+        std::array<aoc::grid<char, Dim, Dim>, 6> faces_;
         std::array<std::array<transition, 4>, 6> face_map_;
         std::array<point, 6> unfolded_;
-        int dim_;
         cube_loc_map<point> cube_pt_to_flat_pt_;
         point_map<int> cube_dir_to_flat_dir_;
 
@@ -480,12 +482,10 @@ namespace {
         }
 
     public:
-        cube_grid( grid& g) : dim_(g.min_cross_section()) {
+        cube_grid( grid& g) {
+            int side = g.min_cross_section();
             for (auto& face : faces_) {
-                face = std::vector<std::vector<char>>(
-                    dim_,
-                    std::vector<char>(dim_, k_empty)
-                );
+                face = aoc::grid<char, Dim, Dim>(side, side, k_empty);
             }
             face_map_ = std::array<std::array<transition, 4>, 6>{ {
                 {{ {k_east, k_right, zero, get_y}, {k_south, k_down, get_x, zero}, {k_west, k_left, get_max, get_y}, {k_north, k_up, get_x, get_max} }}, //top
@@ -501,6 +501,10 @@ namespace {
             copy_grid(g);
         }
 
+        int dim() const {
+            return faces_[0].width();
+        }
+
         point to_flat_point(const cube_point& cp) const {
             return cube_pt_to_flat_pt_.at(cp);
         }
@@ -522,11 +526,11 @@ namespace {
             const transition* trans = nullptr;
             if (new_pt.x < 0) {
                 trans = &face_map_[face][k_left];
-            } else if (new_pt.x == dim_) {
+            } else if (new_pt.x == dim()) {
                 trans = &face_map_[face][k_right];
             } else if (new_pt.y < 0) {
                 trans = &face_map_[face][k_up];
-            } else if (new_pt.y == dim_) {
+            } else if (new_pt.y == dim()) {
                 trans = &face_map_[face][k_down];
             }
             if (!trans) {
@@ -535,27 +539,27 @@ namespace {
             return { 
                 cube_point{
                     trans->face,
-                    point{ trans->x_fn(pt, dim_), trans->y_fn(pt,dim_) }
+                    point{ trans->x_fn(pt, dim()), trans->y_fn(pt,dim()) }
                 },
                 trans->new_dir
             };
         }
 
         char tile(const cube_point& pt) const {
-            return faces_[pt.face][pt.loc.y][pt.loc.x];
+            return faces_[pt.face](pt.loc.x, pt.loc.y);
         }
 
         void set(const cube_point& pt, char ch) {
-            faces_[pt.face][pt.loc.y][pt.loc.x] = ch;
+            faces_[pt.face](pt.loc.x, pt.loc.y) = ch;
         }
 
         void print() const {
-            std::vector<std::vector<char>> g(dim_ * 4, std::vector<char>(dim_ * 3, ' '));
+            std::vector<std::vector<char>> g(dim() * 4, std::vector<char>(dim() * 3, ' '));
             for (int face = 0; face < 6; ++face) {
-                point orig = { unfolded_[face].x * dim_, unfolded_[face].y * dim_ };
-                for (int y = 0; y < dim_; ++y) {
-                    for (int x = 0; x < dim_; ++x) {
-                        g[y + orig.y][x + orig.x] = faces_[face][y][x];
+                point orig = { unfolded_[face].x * dim(), unfolded_[face].y * dim() };
+                for (int y = 0; y < dim(); ++y) {
+                    for (int x = 0; x < dim(); ++x) {
+                        g[y + orig.y][x + orig.x] = faces_[face](x, y);
                     }
                 }
             }
@@ -568,7 +572,8 @@ namespace {
         }
     };
 
-    cube_state follow_instructions(cube_grid& grid, const instructions& insts) {
+    template <int Dim>
+    cube_state follow_instructions(cube_grid<Dim>& grid, const instructions& insts) {
         cube_state s{ grid.starting_loc(), 0 };
         for (const auto& inst : insts) {
             if (inst.go_forward) {
@@ -588,13 +593,25 @@ namespace {
         return s;
     }
 
-    int do_part_2(cube_grid& grid, const instructions& insts) {
+    template <int Dim>
+    int do_part_2(cube_grid<Dim>& grid, const instructions& insts) {
         auto end_cube_state = follow_instructions(grid, insts);
         auto end_state = grid.to_flat_state(end_cube_state);
         end_state.loc = end_state.loc + point{ 1,1 };
 
         return 1000 * end_state.loc.y + 4 * end_state.loc.x + end_state.dir;
     }
+
+    // faces are 50 x 50 in the real input and 4 x 4 in the example
+    int do_part_2(grid& g, const instructions& insts) {
+        int side = g.min_cross_section();
+        return aoc::with_extent<aoc::extent{ 50, 50 }, aoc::extent{ 4, 4 }>(side, side,
+            [&](auto dim, auto)->int {
+                cube_grid<decltype(dim)::value> c_grid(g);
+                return do_part_2(c_grid, insts);
+            }
+        );
+    }
 }
 
 void aoc::day_22(const std::string& title) {
@@ -603,6 +620,5 @@ void aoc::day_22(const std::string& title) {
 
     std::cout << header(22, title);
     std::cout << "  part 1: " << do_part_1(grid, instructions) << "\n";
-    cube_grid c_grid(grid);
-    std::cout << "  part 2: " << do_part_2(c_grid, instructions) << "\n";
+    std::cout << "  part 2: " << do_part_2(grid, instructions) << "\n";
 }
\ No newline at end of file
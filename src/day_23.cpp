@@ -1,13 +1,11 @@
 #include "util.h"
 #include "days.h"
+#include "counters.h"
+#include "bitplane.h"
+#include "checkpoint.h"
 #include <range/v3/all.hpp>
-#include <boost/functional/hash.hpp>
 #include <iostream>
-#include <functional>
-#include <unordered_map>
-#include <unordered_set>
 #include <array>
-#include <limits>
 
 namespace r = ranges;
 namespace rv = ranges::views;
@@ -19,250 +17,219 @@ namespace {
     struct point {
         int x;
         int y;
-
-        bool operator==(const point& p) const {
-            return x == p.x && y == p.y;
-        }
     };
 
-    point operator+(const point& lhs, const point& rhs) {
-        return  { lhs.x + rhs.x, lhs.y + rhs.y };
-    }
-
-    point operator-(const point& lhs, const point& rhs) {
-        return  { lhs.x - rhs.x, lhs.y - rhs.y };
-    }
+    // the elves as one bit per cell. the plane is grown whenever an elf gets near its edge.
+    using elf_grid = aoc::bits::plane;
 
-    point operator*(int lhs, const point& rhs) {
-        return {
-            lhs * rhs.x,
-            lhs * rhs.y
-        };
-    }
+    constexpr int k_margin = 16;
 
-    struct point_hash {
-        size_t operator()(const point& pt) const {
-            size_t seed = 0;
-            boost::hash_combine(seed, pt.x);
-            boost::hash_combine(seed, pt.y);
-            return seed;
-        }
-    };
-
-    using point_set = std::unordered_set<point, point_hash>;
-
-    template<typename T>
-    using point_map = std::unordered_map<point, T, point_hash>;
-
-    point_set input_to_elf_locations(const std::vector<std::string>& input) {
-        int wd = static_cast<int>(input.front().size());
+    elf_grid input_to_elf_locations(const std::vector<std::string>& input) {
+        int wd = input.empty() ? 0 : static_cast<int>(input.front().size());
         int hgt = static_cast<int>(input.size());
-        point_set elves;
+        elf_grid elves(wd, hgt);
         for (int y = 0; y < hgt; ++y) {
             for (int x = 0; x < wd; ++x) {
                 if (input[y][x] == '#') {
-                    elves.insert({ x,y });
+                    elves.set(x, y);
                 }
             }
         }
-        return elves;
+        return elves.extended(k_margin);
+    }
+
+    void ensure_margin(elf_grid& elves) {
+        auto bounds = elves.bounds();
+        if (!bounds) {
+            return;
+        }
+        auto [x1, y1, x2, y2] = *bounds;
+        if (x1 < 1 || y1 < 1 || x2 >= elves.width() - 1 || y2 >= elves.height() - 1) {
+            elves = elves.extended(k_margin);
+        }
     }
 
     enum direction {
         N = 0, NE, E, SE, S, SW, W, NW
     };
 
-    auto all_directions() {
-        return rv::iota(0, 8) |
-            rv::transform([](auto i) {return static_cast<direction>(i); });
-    }
+    constexpr std::array<point, 8> offsets = { {
+        { 0,-1 }, //N
+        { 1,-1 }, //NE
+        { 1, 0 }, //E
+        { 1, 1 }, //SE
+        { 0, 1 }, //S
+        { -1, 1}, //SW
+        { -1,0 }, //W
+        { -1,-1}  //NW
+    } };
 
     point offset_from_dir(direction dir) {
-        static std::array<point, 8> offsets = { {
-            { 0,-1 }, //N 
-            { 1,-1 }, //NE 
-            { 1, 0 }, //E 
-            { 1, 1 }, //SE 
-            { 0, 1 }, //S 
-            { -1, 1}, //SW 
-            { -1,0 }, //W 
-            { -1,-1}  //NW 
-        } };
         return offsets[static_cast<int>(dir)];
     }
 
-    auto adjacent_locs(const point& pt) {
-        return all_directions() |
-            rv::transform(
-                [pt](direction dir) {
-                    return pt + offset_from_dir(dir);
-                }
-            );
-    }
-
-    bool has_neighbor(const point& pt, const point_set& elves) {
-        for (const auto& adj : adjacent_locs(pt)) {
-            if (elves.contains(adj)) {
-                return true;
-            }
-        }
-        return false;
-    }
+    constexpr std::array<direction, 4> prop_dirs = { {
+        N,S,W,E
+    } };
 
-    auto locs_to_check(const point& pt, direction dir) {
-        const static std::unordered_map<direction, std::array<direction, 3>> tbl = {
-            { N, {{NW,N,NE}} },
-            { E, {{NE,E,SE}} },
-            { S, {{SE,S,SW}} },
-            { W, {{SW,W,NW}} }
-        };
-        return tbl.at(dir) |
+    auto proposal_directions(int start_index) {
+        return rv::iota(0, 4) |
             rv::transform(
-                [pt](direction dir) {
-                    return pt + offset_from_dir(dir);
+                [start_index](auto i) {
+                    return prop_dirs[(start_index + i) % 4];
                 }
         );
     }
 
-    bool has_neighbor_in_dir(direction dir, const point& pt, const point_set& elves) {
-        for (const auto& adj : locs_to_check(pt, dir)) {
-            if (elves.contains(adj)) {
-                return true;
-            }
-        }
-        return false;
+    // the cells that have an elf on one of the three cells on the dir side of them
+    elf_grid blocked_in_dir(direction dir, const elf_grid& horz, const elf_grid& vert) {
+        auto offset = offset_from_dir(dir);
+        return ((offset.x == 0) ? horz : vert).shifted(-offset.x, -offset.y);
     }
 
-    struct proposal {
-        point old_loc;
-        point proposed_loc;
-    };
+    elf_grid do_one_round(const elf_grid& elves, int start_index, bool* elf_moved = nullptr) {
+        AOC_COUNT(rounds);
 
-    auto proposal_directions(int start_index) {
-        const static std::array<direction, 4> prop_dirs = { {
-            N,S,W,E
-        } };
-        return rv::iota(0, 4) |
-            rv::transform(
-                [start_index](auto i) {
-                    return prop_dirs.at((start_index + i) % 4);
-                }
-        );
-    }
+        // elves widened to three cells across and three cells down
+        auto horz = elves | elves.shifted(1, 0) | elves.shifted(-1, 0);
+        auto vert = elves | elves.shifted(0, 1) | elves.shifted(0, -1);
 
-    point_set do_one_round(const point_set& elves, int start_index, bool* elf_moved = nullptr) {
-        point_set output;
-        std::vector<proposal> proposals;
-        for (const point& pt : elves) {
-            if (!has_neighbor(pt, elves)) {
-                output.insert(pt);
-                continue;
-            }
-            bool made_proposal = false;
-            for (auto dir : proposal_directions(start_index)) {
-                if (!has_neighbor_in_dir(dir, pt, elves)) {
-                    made_proposal = true;
-                    proposals.push_back({
-                        .old_loc = pt,
-                        .proposed_loc = pt + offset_from_dir(dir)
-                    });
-                    break;
-                }
-            }
-            if (!made_proposal) {
-                output.insert(pt);
-            }
+        std::array<elf_grid, 4> blocked;
+        elf_grid crowded(elves.width(), elves.height());
+        for (int i = 0; i < 4; ++i) {
+            blocked[i] = blocked_in_dir(prop_dirs[i], horz, vert);
+            crowded |= blocked[i];
         }
-        point_map<int> new_loc_counts;
-        for (const auto& prop : proposals) {
-            new_loc_counts[prop.proposed_loc]++;
+        crowded &= elves;
+
+        // each crowded elf proposes the first open direction; the rest stay undecided
+        auto undecided = crowded;
+        std::array<elf_grid, 4> proposals;
+        std::array<elf_grid, 4> targets;
+        std::array<point, 4> moves;
+        int i = 0;
+        for (auto dir : proposal_directions(start_index)) {
+            const auto& blocked_here = blocked[(start_index + i) % 4];
+            moves[i] = offset_from_dir(dir);
+            proposals[i] = aoc::bits::and_not(undecided, blocked_here);
+            targets[i] = proposals[i].shifted(moves[i].x, moves[i].y);
+            undecided &= blocked_here;
+            ++i;
         }
-        for (const auto& prop : proposals) {
-            if (new_loc_counts.at(prop.proposed_loc) == 1) {
-                output.insert(prop.proposed_loc);
-                if (elf_moved) {
-                    *elf_moved = true;
-                }
-            } else {
-                output.insert(prop.old_loc);
+
+        elf_grid clashes(elves.width(), elves.height());
+        for (int j = 0; j < 4; ++j) {
+            for (int k = j + 1; k < 4; ++k) {
+                clashes |= targets[j] & targets[k];
             }
         }
-        return output;
-    }
 
-    std::tuple<int, int, int, int> bounds(const point_set& pts) {
-        int x1 = std::numeric_limits<int>::max();
-        int y1 = std::numeric_limits<int>::max();
-        int x2 = -std::numeric_limits<int>::max();
-        int y2 = -std::numeric_limits<int>::max();
-        for (const auto& pt : pts) {
-            x1 = (pt.x < x1) ? pt.x : x1;
-            y1 = (pt.y < y1) ? pt.y : y1;
-            x2 = (pt.x > x2) ? pt.x : x2;
-            y2 = (pt.y > y2) ? pt.y : y2;
+        auto output = aoc::bits::and_not(elves, crowded) | undecided;
+        bool moved = false;
+        for (int j = 0; j < 4; ++j) {
+            auto arrived = aoc::bits::and_not(targets[j], clashes);
+            moved = moved || arrived.any();
+            output |= arrived;
+            output |= proposals[j] & clashes.shifted(-moves[j].x, -moves[j].y);
+        }
+        if (elf_moved && moved) {
+            *elf_moved = true;
         }
-        return { x1,y1,x2,y2 };
+        return output;
     }
 
-    void print(const point_set& pts) {
-        auto [x1, y1, x2, y2] = bounds(pts);
-        int wd = x2 - x1;
-        int hgt = y2 - y1;
-        point origin = { x1,y1 };
-        for (int y = 0; y <= hgt; ++y) {
-            for (int x = 0; x <= wd; ++x) {
-                point pt{ x,y };
-                std::cout << (pts.contains(origin + pt) ? '#' : '.');
+    void print(const elf_grid& elves) {
+        auto bounds = elves.bounds();
+        if (!bounds) {
+            return;
+        }
+        auto [x1, y1, x2, y2] = *bounds;
+        for (int y = y1; y <= y2; ++y) {
+            for (int x = x1; x <= x2; ++x) {
+                std::cout << (elves.test(x, y) ? '#' : '.');
             }
             std::cout << "\n";
         }
     }
 
-    point_set run_n_rounds(const point_set& pts, int n) {
-        auto set = pts;
+    elf_grid run_n_rounds(const elf_grid& elves, int n) {
+        auto grid = elves;
         int start_dir_index = 0;
         for (int i = 0; i < n; ++i) {
-            set = do_one_round(set, start_dir_index);
+            ensure_margin(grid);
+            grid = do_one_round(grid, start_dir_index);
             start_dir_index = (start_dir_index + 1) % 4;
         }
-        return set;
+        return grid;
     }
 
-    int run_until_no_elf_moves(const point_set& pts) {
-        auto set = pts;
+    // no elves take no rounds to settle
+    int run_until_no_elf_moves(const elf_grid& elves) {
+        if (elves.count() == 0) {
+            return 0;
+        }
+        aoc::checkpoint::snapshot snapshot(
+            "day_23_rounds", 1,
+            aoc::cache::hash_bytes(elves.words().data(), elves.words().size() * sizeof(uint64_t))
+        );
+        auto grid = elves;
         int start_dir_index = 0;
         int round = 0;
+        snapshot.restore(
+            [&](aoc::cache::blob_reader& in) {
+                auto saved_round = in.read<int>();
+                auto wd = in.read<int>();
+                auto hgt = in.read<int>();
+                auto words = in.read_vector<uint64_t>();
+                if (saved_round < 0 || wd < 0 || hgt < 0 ||
+                        words.size() != static_cast<size_t>(hgt) * ((wd + 63) / 64)) {
+                    throw std::runtime_error("bad day 23 checkpoint");
+                }
+                elf_grid saved(wd, hgt);
+                saved.words() = std::move(words);
+                grid = std::move(saved);
+                round = saved_round;
+                start_dir_index = round % 4;
+            }
+        );
+
         bool elf_moved = true;
         while (elf_moved) {
+            snapshot.tick(
+                [&](aoc::cache::blob_writer& out) {
+                    out.write(round);
+                    out.write(grid.width());
+                    out.write(grid.height());
+                    out.write_vector(grid.words());
+                }
+            );
             round++;
             elf_moved = false;
-            set = do_one_round(set, start_dir_index, &elf_moved);
+            ensure_margin(grid);
+            grid = do_one_round(grid, start_dir_index, &elf_moved);
             start_dir_index = (start_dir_index + 1) % 4;
         }
+        snapshot.finish();
         return round;
     }
 
-    int count_empty(const point_set& pts) {
-        auto [x1, y1, x2, y2] = bounds(pts);
-        int wd = x2 - x1;
-        int hgt = y2 - y1;
-        point origin = { x1,y1 };
-        int count = 0;
-        for (int y = 0; y <= hgt; ++y) {
-            for (int x = 0; x <= wd; ++x) {
-                point pt{ x,y };
-                count += pts.contains(origin + pt) ? 0 : 1;
-            }
+    // the empty tiles in the smallest rectangle holding every elf, which is none if there are
+    // no elves
+    int count_empty(const elf_grid& elves) {
+        auto bounds = elves.bounds();
+        if (!bounds) {
+            return 0;
         }
-        return count;
+        auto [x1, y1, x2, y2] = *bounds;
+        return (x2 - x1 + 1) * (y2 - y1 + 1) - static_cast<int>(elves.count());
     }
 }
 
 void aoc::day_23(const std::string& title) {
     auto input = file_to_string_vector(input_path(23, 1));
-    auto set = input_to_elf_locations(input);
+    auto elves = input_to_elf_locations(input);
 
     std::cout << header(23, title);
-    std::cout << "  part 1: " << count_empty(run_n_rounds(set,10)) << "\n";
-    std::cout << "  part 2: " << run_until_no_elf_moves(set) << "\n";
-}
\ No newline at end of file
+    std::cout << "  part 1: " << count_empty(run_n_rounds(elves, 10)) << "\n";
+    std::cout << "  part 2: " << run_until_no_elf_moves(elves) << "\n";
+}
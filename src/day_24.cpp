@@ -1,14 +1,14 @@
 #include "util.h"
 #include "days.h"
+#include "search.h"
+#include "cache.h"
+#include "bitplane.h"
 #include <range/v3/all.hpp>
 #include <iostream>
 #include <functional>
-#include <boost/functional/hash.hpp>
-#include <unordered_map>
-#include <unordered_set>
+#include <algorithm>
 #include <array>
 #include <numeric>
-#include <queue>
 
 namespace r = ranges;
 namespace rv = ranges::views;
@@ -30,17 +30,6 @@ namespace {
         return  { lhs.x + rhs.x, lhs.y + rhs.y };
     }
 
-    struct point_hash {
-        size_t operator()(const point& pt) const {
-            size_t seed = 0;
-            boost::hash_combine(seed, pt.x);
-            boost::hash_combine(seed, pt.y);
-            return seed;
-        }
-    };
-
-    using point_set = std::unordered_set<point, point_hash>;
-
     enum class direction : uint8_t {
         north = 0,
         east,
@@ -49,27 +38,34 @@ namespace {
         none
     };
 
+    constexpr auto char_to_direction_tbl = [] {
+        std::array<direction, 256> tbl = {};
+        tbl.fill(direction::none);
+        tbl['^'] = direction::north;
+        tbl['>'] = direction::east;
+        tbl['v'] = direction::south;
+        tbl['<'] = direction::west;
+        return tbl;
+    }();
+
     std::optional<direction> char_to_direction(char ch) {
-        const static std::unordered_map<char, direction> tbl{
-            {'^', direction::north },
-            {'>', direction::east},
-            {'v', direction::south},
-            {'<', direction::west}
-        };
-        return tbl.contains(ch) ?
-            std::optional<direction>{tbl.at(ch)} :
+        auto dir = char_to_direction_tbl[static_cast<unsigned char>(ch)];
+        return (dir != direction::none) ?
+            std::optional<direction>{dir} :
             std::optional<direction>{};
     }
 
+    // indexed by direction
+    constexpr std::array<point, 5> direction_offsets = { {
+        {0,-1},  // north
+        {1,0},   // east
+        {0,1},   // south
+        {-1,0},  // west
+        {0,0}    // none
+    } };
+
     point direction_to_offset(direction dir) {
-        const static std::unordered_map<direction, point> tbl{
-            { direction::north , {0,-1}},
-            { direction::east  , {1,0}},
-            { direction::south , {0,1}},
-            { direction::west  , {-1,0}},
-            { direction::none  , {0,0}}
-        };
-        return tbl.at(dir);
+        return direction_offsets[static_cast<int>(dir)];
     }
 
     point entrance_loc() {
@@ -87,28 +83,6 @@ namespace {
             (pt != entrance) && (pt != exit);
     }
 
-    point wrap_loc(const point& pt, int wd, int hgt) {
-        auto new_loc = pt;
-        if (new_loc.y == 0) {
-            new_loc.y = hgt - 2;
-        } else if (new_loc.y == hgt - 1) {
-            new_loc.y = 1;
-        } else if (new_loc.x == 0) {
-            new_loc.x = wd - 2;
-        } else if (new_loc.x == wd - 1) {
-            new_loc.x = 1;
-        }
-        return new_loc;
-    }
-
-    point wrapped_neighbor_in_direction(const point& pt, direction dir, int wd, int hgt) {
-        auto new_loc = pt + direction_to_offset(dir);
-        if (is_wall(new_loc, wd, hgt)) {
-            new_loc = wrap_loc(new_loc, wd, hgt);
-        }
-        return new_loc;
-    }
-
     std::optional<point> neighbor_in_direction(const point& pt, direction dir, int wd, int hgt) {
         auto new_loc = pt + direction_to_offset(dir);
         if (is_wall(new_loc, wd, hgt)) {
@@ -117,34 +91,41 @@ namespace {
         return new_loc;
     }
 
+    // one bit plane per direction over the interior of the valley, so moving every blizzard
+    // is four whole-plane rotations. points are in valley coordinates, walls included.
     class blizzard_set {
         int wd_;
         int hgt_;
-        std::array<point_set, 4> impl_;
+        std::array<aoc::bits::plane, 4> impl_;
+        aoc::bits::plane occupied_;
+
+        void update_occupied() {
+            occupied_ = impl_[0] | impl_[1] | impl_[2] | impl_[3];
+        }
+
     public:
 
         blizzard_set(int wd = 0, int hgt = 0) :
             wd_(wd),
-            hgt_(hgt) 
-        {}
+            hgt_(hgt),
+            occupied_(std::max(wd - 2, 0), std::max(hgt - 2, 0))
+        {
+            impl_.fill(occupied_);
+        }
 
         void insert(const point& loc, direction dir) {
-            impl_[static_cast<int>(dir)].insert(loc);
+            impl_[static_cast<int>(dir)].set(loc.x - 1, loc.y - 1);
+            occupied_.set(loc.x - 1, loc.y - 1);
         }
 
         bool contains(const point& pt) const {
-            for (const auto& ps : impl_) {
-                if (ps.contains(pt)) {
-                    return true;
-                }
-            }
-            return false;
+            return occupied_.test(pt.x - 1, pt.y - 1);
         }
 
         int count(const point& pt) const {
             int n = 0;
-            for (const auto& ps : impl_) {
-                if (ps.contains(pt)) {
+            for (const auto& plane : impl_) {
+                if (plane.test(pt.x - 1, pt.y - 1)) {
                     ++n;
                 }
             }
@@ -159,17 +140,36 @@ namespace {
             return hgt_;
         }
 
+        void save(aoc::cache::blob_writer& out) const {
+            out.write(wd_);
+            out.write(hgt_);
+            for (const auto& plane : impl_) {
+                out.write_vector(plane.words());
+            }
+        }
+
+        static blizzard_set load(aoc::cache::blob_reader& in) {
+            auto wd = in.read<int>();
+            auto hgt = in.read<int>();
+            blizzard_set set(wd, hgt);
+            for (auto& plane : set.impl_) {
+                auto words = in.read_vector<uint64_t>();
+                if (words.size() != plane.words().size()) {
+                    throw std::runtime_error("bad blizzard plane in cache artifact");
+                }
+                plane.words() = std::move(words);
+            }
+            set.update_occupied();
+            return set;
+        }
+
         blizzard_set next() const {
             blizzard_set next_set(wd_, hgt_);
             for (int i = 0; i < 4; ++i) {
-                auto dir = static_cast<direction>(i);
-                for (const auto& pt : impl_[i]) {
-                    next_set.insert(
-                        wrapped_neighbor_in_direction(pt, dir, wd_, hgt_), 
-                        dir
-                    );
-                }
+                auto offset = direction_to_offset(static_cast<direction>(i));
+                next_set.impl_[i] = impl_[i].rotated(offset.x, offset.y);
             }
+            next_set.update_occupied();
             return next_set;
         }
     };
@@ -201,10 +201,32 @@ namespace {
         return atlas;
     }
 
+    void save_atlas(aoc::cache::blob_writer& out, const blizzard_atlas& atlas) {
+        out.write(static_cast<uint64_t>(atlas.size()));
+        for (const auto& frame : atlas) {
+            frame.save(out);
+        }
+    }
+
+    blizzard_atlas load_atlas(aoc::cache::blob_reader& in) {
+        auto n = in.read<uint64_t>();
+        // every frame is at least its two dimensions and a plane's word count, which bounds a
+        // corrupt count before it is used to reserve; there is always at least one frame
+        constexpr size_t k_min_frame_bytes = 2 * sizeof(int) + sizeof(uint64_t);
+        if (n == 0 || n > in.remaining() / k_min_frame_bytes) {
+            throw std::runtime_error("bad blizzard atlas in cache artifact");
+        }
+        blizzard_atlas atlas;
+        atlas.reserve(n);
+        for (uint64_t i = 0; i < n; ++i) {
+            atlas.push_back(blizzard_set::load(in));
+        }
+        return atlas;
+    }
+
     struct state {
         point loc;
         int time;
-        std::vector<point> path;
 
         bool operator==(const state& s) const {
             return loc == s.loc && time == s.time;
@@ -218,18 +240,6 @@ namespace {
         }
     };
 
-    struct state_hash {
-        size_t operator()(const state& s) const {
-            size_t seed = 0;
-            boost::hash_combine(seed, s.loc.x);
-            boost::hash_combine(seed, s.loc.y);
-            boost::hash_combine(seed, s.time);
-            return seed;
-        }
-    };
-
-    using state_set = std::unordered_set<state, state_hash>;
-
     auto directions() {
         return rv::iota(0, 5) | rv::transform([](int i) {return static_cast<direction>(i); });
     }
@@ -267,32 +277,38 @@ namespace {
             );
     }
 
-    int min_time_crossing(  const blizzard_atlas& atlas, const point& from, 
-                const point& to, int start_time) {
-        int atlas_sz = static_cast<int>(atlas.size());
-        int wd = atlas.front().width();
-        int hgt = atlas.front().height();
-        std::queue<state> queue;
-        queue.push({ from, start_time });
-        state_set visited;
-        while (!queue.empty()) {
-            auto state = queue.front();
-            queue.pop();
-
-            if (state.loc == to) {
-                return state.time;
-            }
+    class crossing_problem {
+        const blizzard_atlas& atlas_;
+        point to_;
+    public:
+        crossing_problem(const blizzard_atlas& atlas, const point& to) :
+            atlas_(atlas),
+            to_(to)
+        {}
 
-            if (visited.contains(state.normalized(atlas_sz))){
-                continue;
-            }
-            visited.insert(state.normalized(atlas_sz));
+        bool is_goal(const state& s) const {
+            return s.loc == to_;
+        }
+
+        uint64_t key(const state& s) const {
+            auto normalized = s.normalized(static_cast<int>(atlas_.size()));
+            return static_cast<uint64_t>(static_cast<uint16_t>(normalized.loc.x)) |
+                (static_cast<uint64_t>(static_cast<uint16_t>(normalized.loc.y)) << 16) |
+                (static_cast<uint64_t>(normalized.time) << 32);
+        }
 
-            for (auto&& new_state : neighbors_at_place_and_time(state, atlas)) {
-                queue.push(new_state);
+        void successors(const state& s, auto&& emit) const {
+            for (auto&& new_state : neighbors_at_place_and_time(s, atlas_)) {
+                emit(new_state);
             }
         }
-        return -1;
+    };
+
+    int min_time_crossing(  const blizzard_atlas& atlas, const point& from, 
+                const point& to, int start_time) {
+        crossing_problem problem(atlas, to);
+        auto result = aoc::search::bfs(problem, state{ from, start_time });
+        return result ? result->time : -1;
     }
 
     int min_time_crossing_back_and_forth(
@@ -308,7 +324,12 @@ namespace {
 
 void aoc::day_24(const std::string& title) {
     auto input = file_to_string_vector(input_path(24, 1));
-    auto atlas = make_blizzard_atlas(parse_input(input));
+    auto atlas = aoc::cache::get_or_build(
+        { "day_24_blizzard_atlas", 2, aoc::cache::hash_lines(input) },
+        [&input]() { return make_blizzard_atlas(parse_input(input)); },
+        save_atlas,
+        load_atlas
+    );
 
     int wd = atlas.front().width();
     int hgt = atlas.front().height();
@@ -1,10 +1,14 @@
 #include "util.h"
 #include "days.h"
+#ifdef AOC_EMBED_INPUT
+#include "embedded_input.h"
+#endif
 #include <range/v3/all.hpp>
 #include <iostream>
 #include <functional>
 #include <sstream>
 #include <deque>
+#include <string_view>
 
 namespace r = ranges;
 namespace rv = ranges::views;
@@ -90,7 +94,7 @@ namespace {
         ) | r::to<std::string>();
     }
 
-    number snafu_numeral_to_digit(char numeral) {
+    constexpr number snafu_numeral_to_digit(char numeral) {
         if (numeral >= '0' && numeral <= '2') {
             return static_cast<number>(numeral - '0');
         }
@@ -103,6 +107,13 @@ namespace {
         throw std::runtime_error("bad snafu digit");
     }
 
+    std::string to_snafu_number(number num) {
+        return to_string(
+            to_snafu_number_digits(num)
+        );
+    }
+
+#ifndef AOC_EMBED_INPUT
     number from_snafu_number(const std::string& snafu) {
         number fives = 1;
         number value = 0;
@@ -119,19 +130,35 @@ namespace {
             static_cast<number>(0)
         );
     }
-
-    std::string to_snafu_number(number num) {
-        return to_string(
-            to_snafu_number_digits(num)
-        );
+#else
+    constexpr number sum_of_snafu_numbers(std::string_view input) {
+        number sum = 0;
+        number value = 0;
+        for (char numeral : input) {
+            if (numeral == '\n') {
+                sum += value;
+                value = 0;
+                continue;
+            }
+            value = 5 * value + snafu_numeral_to_digit(numeral);
+        }
+        return sum + value;
     }
+
+    constexpr number k_embedded_sum = sum_of_snafu_numbers(aoc::embedded::day_25);
+#endif
 }
 
 void aoc::day_25(const std::string& title) {
 
+#ifdef AOC_EMBED_INPUT
+    auto sum = k_embedded_sum;
+#else
     auto input = file_to_string_vector(input_path(25, 1));
+    auto sum = sum_of_snafu_numbers(input);
+#endif
 
     std::cout << header(25, title);
-    std::cout << "  part 1: " << to_snafu_number(sum_of_snafu_numbers(input)) << "\n";
+    std::cout << "  part 1: " << to_snafu_number(sum) << "\n";
     std::cout << "  part 2: " << 0 << "\n";
 }
\ No newline at end of file
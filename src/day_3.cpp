@@ -1,82 +1,79 @@
 #include "util.h"
 #include "days.h"
-#include <range/v3/all.hpp>
-#include <vector>
+#include "simd.h"
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
 #include <string>
 #include <iostream>
-#include <unordered_set>
-
-namespace r = ranges;
-namespace rv = ranges::views;
+#include <tuple>
 
 /*------------------------------------------------------------------------------------------------*/
 
 namespace {
-    std::tuple<std::string, std::string> split_string_in_half(const std::string& str) {
-        auto n = str.size() / 2;
-        return { str.substr(0, n), str.substr(n, n) };
-    }
 
-    char shared_item_letter(const std::string& input_line) {
-        auto [rucksack_1,rucksack_2] = split_string_in_half(input_line);
-        auto items_in_rucksack_1 = rucksack_1 | r::to<std::unordered_set<char>>();
-        return *r::find_if(rucksack_2,
-            [&items_in_rucksack_1](auto rucksack_2_item) {
-                return items_in_rucksack_1.find(rucksack_2_item) != items_in_rucksack_1.end();
-            }
-        );
+    // item sets are letter sets, a to z then A to Z, so an item's priority is its bit index + 1.
+    // this is the priority of the one item in a set, or 0 if there is none
+    int priority(uint64_t items) {
+        return items ? std::countr_zero(items) + 1 : 0;
     }
 
-    int priority_from_letter(char item) {
-        return (std::islower(item)) ? (item - 'a') + 1 : (item - 'A') + 27;
-    }
+    // both parts in one pass over the raw text with no allocation: each rucksack's compartments
+    // are item sets, built with simd, whose intersection is the misplaced item, and each group's
+    // badge is the intersection of its group_size rucksacks
+    std::tuple<int64_t, int64_t> sum_priorities(const char* data, size_t n, int group_size) {
+        int64_t part1 = 0;
+        int64_t part2 = 0;
+        uint64_t group_items = ~uint64_t{ 0 };
+        int rucksacks_in_group = 0;
 
-    // part 2 ...
-    char shared_letter(auto rng) {
-        auto letter_sets = rng |
-            rv::transform(
-                [](const std::string& inp_line) {
-                    return inp_line | r::to<std::unordered_set<char>>();
-                }
-            ) | r::to_vector;
-        for (char seed : rng[0]) {
-            bool appears_in_all_sets = true;
-            for (const auto& letter_set : letter_sets) {
-                if (letter_set.find(seed) == letter_set.end()) {
-                    appears_in_all_sets = false;
-                    break;
+        const char* end = data + n;
+        while (data < end) {
+            auto len = aoc::simd::find_byte(data, end - data, '\n');
+            auto line_end = data + len;
+            auto items_end = (len > 0 && line_end[-1] == '\r') ? line_end - 1 : line_end;
+            if (items_end != data) {
+                auto middle = data + (items_end - data) / 2;
+                auto first = aoc::simd::letter_set(data, middle - data);
+                auto second = aoc::simd::letter_set(middle, items_end - middle);
+                part1 += priority(first & second);
+
+                group_items &= first | second;
+                if (++rucksacks_in_group == group_size) {
+                    part2 += priority(group_items);
+                    group_items = ~uint64_t{ 0 };
+                    rucksacks_in_group = 0;
                 }
             }
-            if (appears_in_all_sets) {
-                return seed;
+            if (line_end == end) {
+                break;
             }
+            data = line_end + 1;
+        }
+        if (rucksacks_in_group != 0) {
+            throw std::runtime_error("day 3: the rucksacks do not divide into whole groups");
         }
+        return { part1, part2 };
+    }
+
+    // elves are grouped in threes unless AOC_DAY_3_GROUP_SIZE says otherwise. a group of one
+    // has no badge to find, as its one rucksack's items all trivially match.
+    int group_size() {
+        const char* size = std::getenv("AOC_DAY_3_GROUP_SIZE");
+        int k = (size && *size) ? std::atoi(size) : 3;
+        if (k < 2) {
+            throw std::runtime_error("day 3: the group size must be at least 2");
+        }
+        return k;
     }
 }
 
 void aoc::day_3(const std::string& title) {
-    auto input = file_to_string_vector(input_path(3, 1));
-    auto part_1 = r::accumulate(
-        input | rv::transform(
-            [](const auto& inp_line)->int {
-                return priority_from_letter(shared_item_letter(inp_line));
-            }
-        ),
-        0
-    );
-    
-    auto part_2 = r::accumulate(
-        input |
-            rv::chunk(3) |
-            rv::transform(
-                [](auto triple) {
-                    return priority_from_letter(shared_letter(triple));
-                }
-            ),
-        0
-    );
+    aoc::mapped_file input(input_path(3, 1));
+    auto [part_1, part_2] = sum_priorities(input.data(), input.size(), group_size());
 
     std::cout << header(3, title);
     std::cout << "  part 1: " << part_1 << "\n";
     std::cout << "  part 2: " << part_2 << "\n";
-}
\ No newline at end of file
+}
@@ -1,13 +1,17 @@
 #include "util.h"
 #include "days.h"
-#include <range/v3/all.hpp>
+#include "simd.h"
+#ifdef AOC_EMBED_INPUT
+#include "embedded_input.h"
+#endif
+#include <array>
+#include <cstdint>
+#include <stdexcept>
 #include <vector>
 #include <string>
 #include <iostream>
 #include <tuple>
-
-namespace r = ranges;
-namespace rv = ranges::views;
+#include <string_view>
 
 /*------------------------------------------------------------------------------------------------*/
 
@@ -17,66 +21,117 @@ namespace {
         int to;
     };
 
-    bool is_in_interval(const interval& intv, int v) {
+    constexpr bool is_in_interval(const interval& intv, int v) {
         return v >= intv.from && v <= intv.to;
     }
 
-    bool is_contained_by(const interval& container, const interval& containee) {
+    constexpr bool is_contained_by(const interval& container, const interval& containee) {
         return is_in_interval(container, containee.from) &&
             is_in_interval(container, containee.to);
     }
 
-    bool overlaps(const interval& lhs, const interval& rhs) {
-        if (is_in_interval(rhs, lhs.from)) {
-            return true;
+    // branch free: two intervals overlap unless one ends before the other starts
+    constexpr bool overlaps(const interval& lhs, const interval& rhs) {
+        return (lhs.from <= rhs.to) & (rhs.from <= lhs.to);
+    }
+
+#ifndef AOC_EMBED_INPUT
+    // the assignment pairs as four columns, one entry per line
+    struct assignment_columns {
+        std::vector<int32_t> a_from;
+        std::vector<int32_t> a_to;
+        std::vector<int32_t> b_from;
+        std::vector<int32_t> b_to;
+    };
+
+    // one pass over the raw text: every run of digits is the next number, and the numbers go to
+    // the four columns in turn
+    assignment_columns parse_assignments(const char* data, size_t n) {
+        assignment_columns cols;
+        std::array<std::vector<int32_t>*, 4> columns = {
+            &cols.a_from, &cols.a_to, &cols.b_from, &cols.b_to
+        };
+        auto lines = aoc::simd::count_byte(data, n, '\n') + 1;
+        for (auto column : columns) {
+            column->reserve(lines);
         }
-        if (is_in_interval(rhs, lhs.to)) {
-            return true;
+
+        size_t column = 0;
+        int32_t value = 0;
+        bool in_number = false;
+        for (size_t i = 0; i < n; ++i) {
+            auto digit = static_cast<unsigned>(data[i] - '0');
+            if (digit < 10) {
+                value = 10 * value + static_cast<int32_t>(digit);
+                in_number = true;
+            } else if (in_number) {
+                columns[column]->push_back(value);
+                column = (column + 1) % columns.size();
+                value = 0;
+                in_number = false;
+            }
         }
-        if (is_in_interval(lhs, rhs.from)) {
-            return true;
+        if (in_number) {
+            columns[column]->push_back(value);
+            column = (column + 1) % columns.size();
         }
-        if (is_in_interval(lhs, rhs.to)) {
-            return true;
+        if (column != 0) {
+            throw std::runtime_error("day 4: every line must be a pair of intervals");
         }
-        return false;
+        return cols;
     }
 
-    interval string_to_interval(const std::string& str) {
-        auto from_to = aoc::split(str, '-');
-        return { std::stoi(from_to[0]), std::stoi(from_to[1]) };
+    // (fully contained count, overlapping count) in one pass over the columns, four or eight
+    // pairs at a time with the simd compare kernels
+    std::tuple<int, int> count_contained_and_overlapping(const assignment_columns& cols) {
+        auto [contained, overlapping] = aoc::simd::count_interval_pairs(
+            cols.a_from.data(), cols.a_to.data(), cols.b_from.data(), cols.b_to.data(),
+            cols.a_from.size()
+        );
+        return { static_cast<int>(contained), static_cast<int>(overlapping) };
+    }
+#else
+    constexpr int parse_int(std::string_view str, size_t& pos) {
+        int val = 0;
+        while (pos < str.size() && str[pos] >= '0' && str[pos] <= '9') {
+            val = 10 * val + (str[pos++] - '0');
+        }
+        return val;
     }
 
-    std::tuple<interval, interval> parse_line_of_input(const std::string& inp_line) {
-        auto pieces = aoc::split(inp_line, ',');
-        return { string_to_interval(pieces[0]), string_to_interval(pieces[1]) };
+    // (fully contained count, overlapping count) computed by the compiler from the embedded
+    // input; lines are "a-b,c-d\n".
+    constexpr std::tuple<int, int> count_contained_and_overlapping(std::string_view input) {
+        int contained = 0;
+        int overlapping = 0;
+        size_t pos = 0;
+        while (pos < input.size()) {
+            interval intv1 = {};
+            interval intv2 = {};
+            intv1.from = parse_int(input, pos);
+            intv1.to = parse_int(input, ++pos);
+            intv2.from = parse_int(input, ++pos);
+            intv2.to = parse_int(input, ++pos);
+            ++pos;
+            contained += (is_contained_by(intv1, intv2) || is_contained_by(intv2, intv1)) ? 1 : 0;
+            overlapping += overlaps(intv1, intv2) ? 1 : 0;
+        }
+        return { contained, overlapping };
     }
+
+    constexpr auto k_embedded_counts = count_contained_and_overlapping(aoc::embedded::day_4);
+#endif
 }
 
 void aoc::day_4(const std::string& title) {
-    auto input = file_to_string_vector(input_path(4, 1));
-
-    int part_1 = r::accumulate(
-        input |
-            rv::transform(
-                [](const std::string& inp_line)->int {
-                    auto [intv1, intv2] = parse_line_of_input(inp_line);
-                    return (is_contained_by(intv1, intv2) || is_contained_by(intv2, intv1)) ? 1 : 0;
-                }
-            ),
-        0
+#ifdef AOC_EMBED_INPUT
+    auto [part_1, part_2] = k_embedded_counts;
+#else
+    aoc::mapped_file input(input_path(4, 1));
+    auto [part_1, part_2] = count_contained_and_overlapping(
+        parse_assignments(input.data(), input.size())
     );
-
-    int part_2 = r::accumulate(
-        input |
-            rv::transform(
-                [](const std::string& inp_line)->int {
-                    auto [intv1, intv2] = parse_line_of_input(inp_line);
-                    return overlaps(intv1,intv2) ? 1 : 0;
-                }
-            ),
-        0
-    ); 
+#endif
 
     std::cout << header(4, title);
     std::cout << "   part 1: " << part_1 << "\n";
@@ -1,10 +1,11 @@
 #include "util.h"
 #include "days.h"
+#include "interner.h"
+#include "csr_graph.h"
 #include <range/v3/all.hpp>
 #include <array>
-#include <unordered_map>
+#include <tuple>
 #include <iostream>
-#include <memory>
 #include <functional>
 
 namespace r = ranges;
@@ -14,148 +15,150 @@ namespace rv = ranges::views;
 
 namespace {
 
+    // directories live in one vector, the root first, and refer to each other by index. size
+    // is the total of the files directly in a directory.
     struct directory {
-        std::unordered_map<std::string, std::shared_ptr<directory>> directories;
-        std::weak_ptr<directory> parent;
+        std::vector<std::tuple<int, int>> directories; // (interned name, directory index)
+        int parent;
         int size;
-
-        directory() : size(0)
-        {}
     };
 
-    using dir_ptr = std::shared_ptr<directory>;
-    using command = std::function<dir_ptr(const dir_ptr& current_dir)>;
-    using command_parser = std::function<command(const std::string& line)>;
+    using file_system = std::vector<directory>;
+
+    constexpr int k_root = 0;
+    constexpr int k_no_change = -1;
+
+    // a command returns the new current directory or k_no_change
+    using command = std::function<int(file_system& fs, int current_dir)>;
+    using command_parser = std::function<command(const std::string& line, aoc::interner& names)>;
 
-    command parse_create_directory(const std::string& line) {
+    command parse_create_directory(const std::string& line, aoc::interner& names) {
         auto pieces = aoc::split(line, ' ');
         if (pieces.size() == 2 && pieces[0] == "dir") {
-            return [dir_name = pieces[1]](const dir_ptr& current_dir)->dir_ptr {
-                auto new_directory = std::make_shared<directory>();
-                new_directory->parent = std::weak_ptr<directory>(current_dir);
-                current_dir->directories[dir_name] = new_directory;
-                return {};
+            return [dir_name = names.intern(pieces[1])](file_system& fs, int current_dir)->int {
+                fs.push_back({ {}, current_dir, 0 });
+                fs[current_dir].directories.emplace_back(dir_name, static_cast<int>(fs.size()) - 1);
+                return k_no_change;
             };
         } 
         return {};
     }
 
-    command parse_file_size(const std::string& line) {
+    command parse_file_size(const std::string& line, aoc::interner& names) {
         auto pieces = aoc::split(line, ' ');
         if (pieces.size() == 2 && aoc::is_number(pieces[0])) {
             int sz = std::stoi(pieces[0]);
-            return [sz](const dir_ptr& current_dir)->dir_ptr {
-                current_dir->size += sz;
-                return {};
+            return [sz](file_system& fs, int current_dir)->int {
+                fs[current_dir].size += sz;
+                return k_no_change;
             };
         }
         return {};
     }
         
-    command parse_cd(const std::string& line) {
+    command parse_cd(const std::string& line, aoc::interner& names) {
         auto pieces = aoc::split(line, ' ');
         if (pieces.size() == 3 && pieces[0] == "$" &&  pieces[1] == "cd") {
-            auto dir_name = pieces[2];
+            const auto& dir_name = pieces[2];
             if (dir_name == "/") {
-                return [](const dir_ptr& current_dir)->dir_ptr {
-                    return std::make_shared<directory>();
+                return [](file_system& fs, int current_dir)->int {
+                    return k_root;
                 };
             } else if (dir_name == "..") {
-                return [](const dir_ptr& current_dir)->dir_ptr {
-                    return current_dir->parent.lock();
+                return [](file_system& fs, int current_dir)->int {
+                    return fs[current_dir].parent;
                 };
             } else  {
-                return [dir_name](const dir_ptr& current_dir)->dir_ptr {
-                    return current_dir->directories[dir_name];
+                return [dir_name = names.intern(dir_name)](file_system& fs, int current_dir)->int {
+                    for (auto [name, index] : fs[current_dir].directories) {
+                        if (name == dir_name) {
+                            return index;
+                        }
+                    }
+                    throw std::runtime_error("cd to an unknown directory");
                 };
             }
         }
         return {};
     }
 
-    command parse_line(const std::string& line) {
+    command parse_line(const std::string& line, aoc::interner& names) {
         const static std::array<command_parser,3> parsers = {
             parse_create_directory,
             parse_file_size,
             parse_cd
         };
         for (const auto& parser : parsers) {
-            auto cmd = parser(line);
+            auto cmd = parser(line, names);
             if (cmd) {
                 return cmd;
             }
         }
-        return [](const dir_ptr& current_dir)->dir_ptr {return {}; };
+        return [](file_system& fs, int current_dir)->int {return k_no_change; };
     }
 
-    auto child_directories(dir_ptr dir) {
-        return dir->directories | rv::transform([](auto pair) {return pair.second; });
-    }
-
-    void populate_directory_sizes(dir_ptr root) {
-        for (auto child : child_directories(root)) {
-            populate_directory_sizes(child);
-        }
-        auto size_of_directories = r::accumulate(
-            child_directories(root) | rv::transform([](auto child) {return child->size; }),
-            0
-        );
-        root->size += size_of_directories;
-    }
-
-    dir_ptr construct_file_system(auto commands) {
-        dir_ptr root;
-        dir_ptr current_dir;
+    file_system construct_file_system(auto commands) {
+        file_system fs = { directory{ {}, k_root, 0 } };
+        int current_dir = k_root;
         for (auto cmd : commands) {
-            auto new_dir = cmd(current_dir);
-            if (!root) {
-                root = new_dir;
-            }
-            if (new_dir) {
+            auto new_dir = cmd(fs, current_dir);
+            if (new_dir != k_no_change) {
                 current_dir = new_dir;
             }
         }
-        populate_directory_sizes(root);
-        return root;
+        return fs;
     }
 
-    int size_of_directories_at_most_100000(dir_ptr root) {
-        int size = (root->size <= 100000) ? root->size : 0;
-        for (auto child : child_directories(root)) {
-            size += size_of_directories_at_most_100000(child);
+    // the total size of each directory, by summing the file sizes up the tree of parent -> child
+    // edges in post order
+    std::vector<int> directory_sizes(const file_system& fs) {
+        int n = static_cast<int>(fs.size());
+        std::vector<aoc::csr::edge> edges;
+        edges.reserve(n);
+        for (int i = k_root + 1; i < n; ++i) {
+            edges.push_back({ fs[i].parent, i });
         }
-        return size;
+        aoc::csr::graph tree(n, edges);
+        auto sizes = fs |
+            rv::transform([](const directory& dir) {return dir.size; }) |
+            r::to_vector;
+        aoc::csr::aggregate(tree, aoc::csr::post_order(tree, k_root), sizes, std::plus<int>());
+        return sizes;
+    }
+
+    int size_of_directories_at_most_100000(const std::vector<int>& sizes) {
+        return r::accumulate(
+            sizes | rv::filter([](int size) {return size <= 100000; }),
+            0
+        );
     }
 
     constexpr auto total_disk_space = 70000000;
     constexpr auto space_required = 30000000;
 
-    int size_of_directory_to_delete(dir_ptr root) {
-        auto unused_space = total_disk_space - root->size;
+    int size_of_directory_to_delete(const std::vector<int>& sizes) {
+        auto unused_space = total_disk_space - sizes[k_root];
         auto space_needed_to_free_up = space_required - unused_space;
-        std::vector<int> large_enough_dir_sizes;
-
-        std::function<void(dir_ptr)> find_large_enough_dirs;
-        find_large_enough_dirs = [&](dir_ptr p) {
-            for (auto child : child_directories(p)) {
-                if (child->size >= space_needed_to_free_up) {
-                    large_enough_dir_sizes.push_back(child->size);
-                    find_large_enough_dirs(child);
-                }
-            }
-        };
-
-        find_large_enough_dirs(root);
-        return r::min(large_enough_dir_sizes);
+        return r::min(
+            sizes |
+                rv::drop(1) |
+                rv::filter([&](int size) {return size >= space_needed_to_free_up; })
+        );
     }
 }
 
 void aoc::day_7(const std::string& title) {
     auto input = file_to_string_vector(input_path(7, 1));
-    auto commands = input | rv::transform(parse_line);
-    auto root_dir = construct_file_system(commands);
+    aoc::interner names;
+    auto commands = input |
+        rv::transform(
+            [&names](const std::string& line) {
+                return parse_line(line, names);
+            }
+        );
+    auto sizes = directory_sizes(construct_file_system(commands));
 
     std::cout << header(7, title);
-    std::cout << "   part 1: " << size_of_directories_at_most_100000(root_dir) << "\n";
-    std::cout << "   part 2: " << size_of_directory_to_delete(root_dir) << "\n";
-}
\ No newline at end of file
+    std::cout << "   part 1: " << size_of_directories_at_most_100000(sizes) << "\n";
+    std::cout << "   part 2: " << size_of_directory_to_delete(sizes) << "\n";
+}
@@ -1,5 +1,6 @@
 #include "util.h"
 #include "days.h"
+#include "grid.h"
 #include <range/v3/all.hpp>
 #include <iostream>
 #include <filesystem>
@@ -14,8 +15,6 @@ namespace rv = ranges::views;
 /*------------------------------------------------------------------------------------------------*/
 
 namespace{
-    using grid = std::vector<std::vector<int>>;
-
     struct grid_loc {
         int value;
         int col;
@@ -43,13 +42,7 @@ namespace{
 
     using grid_loc_set = std::unordered_set<grid_loc, hash_grid_loc, grid_loc_equal>;
 
-    bool is_in_grid(const grid& ary, int col, int row) {
-        int columns = static_cast<int>(ary[0].size());
-        int rows = static_cast<int>(ary.size());
-        return row >= 0 && row < rows&& col >= 0 && col < columns;
-    }
-
-    auto line(const grid& ary, int c, int r, int col_offset, int row_offset) {
+    auto line(const auto& ary, int c, int r, int col_offset, int row_offset) {
         return rv::iota(0) |
             rv::transform(
                 [c, r, col_offset, row_offset](int n)->std::tuple<int, int> {
@@ -61,13 +54,13 @@ namespace{
             ) | rv::take_while(
                 [&ary](auto&& c_r) {
                     auto [col, row] = c_r;
-                    return is_in_grid(ary, col, row);
+                    return ary.contains(col, row);
                 }
             ) | rv::transform(
                 [&ary](auto&& c_r)->grid_loc {
                     auto [col, row] = c_r;
                     return {
-                        ary[row][col],
+                        ary(col, row),
                         col,
                         row
                     };
@@ -75,8 +68,8 @@ namespace{
             );
     }
 
-    auto rows(const grid& ary) {
-        int n = static_cast<int>(ary.size());
+    auto rows(const auto& ary) {
+        int n = ary.height();
         return rv::iota(0, n) |
             rv::transform(
                 [&ary](int row_index) {
@@ -85,8 +78,8 @@ namespace{
             );
     }
 
-    auto columns(const grid& ary) {
-        int n = static_cast<int>(ary[0].size());
+    auto columns(const auto& ary) {
+        int n = ary.width();
         return rv::iota(0, n) |
             rv::transform(
                 [&ary](int col_index) {
@@ -95,10 +88,6 @@ namespace{
         );
     }
 
-    auto all_grid_locs(const grid& ary) {
-        return rows(ary) | rv::join;
-    }
-
     auto running_max(auto rng) {
         return rv::partial_sum(rng, [](int lhs, int rhs) { return std::max(lhs, rhs); });
     }
@@ -122,7 +111,7 @@ namespace{
             );
     }
 
-    int num_visible(const grid& ary) {
+    int num_visible(const auto& ary) {
         auto visible_set = rv::concat(rows(ary), columns(ary)) |
             rv::transform([](auto rng) {
                 return rv::concat(
@@ -136,20 +125,23 @@ namespace{
         return static_cast<int>(visible_set.size());
     }
 
-    int viewing_distance(const grid& ary, int col, int row, int col_offset, int row_offset) {
-        int max_height = ary[row][col];
+    int viewing_distance(const auto& ary, int col, int row, int col_offset, int row_offset) {
+        int max_height = ary(col, row);
         int count = 0;
-        for (int v : line(ary, col, row, col_offset, row_offset) | 
-                rv::drop(1) | rv::transform([](const auto& grid_loc) {return grid_loc.value; })) {
+        int c = col + col_offset;
+        int r = row + row_offset;
+        while (ary.contains(c, r)) {
             count++;
-            if (v >= max_height) {
+            if (ary(c, r) >= max_height) {
                 return count;
             }
+            c += col_offset;
+            r += row_offset;
         }
         return count;
     }
 
-    int scenic_score(const grid& ary, int col, int row) {
+    int scenic_score(const auto& ary, int col, int row) {
         const static std::array<std::tuple<int, int>, 4> directions = {{
             {1, 0},
             {0, 1},
@@ -169,23 +161,41 @@ namespace{
         );
     }
 
-    int highest_scenic_score(const grid& ary) {
-        return r::max(
-            all_grid_locs(ary) |
-            rv::transform(
-                [&ary](auto grid_loc)->int {
-                    return scenic_score(ary, grid_loc.col, grid_loc.row);
+    int highest_scenic_score(const auto& ary) {
+        int cols = ary.width();
+        int rows = ary.height();
+        return aoc::parallel_transform_reduce(
+            0, static_cast<int64_t>(cols) * rows, 0,
+            [](int lhs, int rhs) { return std::max(lhs, rhs); },
+            [&ary, cols](int64_t i)->int {
+                return scenic_score(ary, static_cast<int>(i % cols), static_cast<int>(i / cols));
+            }
+        );
+    }
+
+    // the forest is 99 x 99 in the real input and 5 x 5 in the example; those sizes get static
+    // extents and anything else a dynamic grid.
+    std::tuple<int, int> solve(const std::vector<std::string>& input) {
+        int wd = static_cast<int>(input.front().size());
+        int hgt = static_cast<int>(input.size());
+        return aoc::with_grid<int, aoc::extent{ 99, 99 }, aoc::extent{ 5, 5 }>(wd, hgt,
+            [&](auto forest)->std::tuple<int, int> {
+                for (int row = 0; row < hgt; ++row) {
+                    for (int col = 0; col < wd; ++col) {
+                        forest(col, row) = input[row][col] - '0';
+                    }
                 }
-            )
+                return { num_visible(forest), highest_scenic_score(forest) };
+            }
         );
     }
 }
 
 void aoc::day_8( const std::string& title) {
-    auto input_strings = file_to_string_vector(input_path(8, 1));
-    auto input = strings_to_2D_array_of_digits(input_strings);
+    auto input = file_to_string_vector(input_path(8, 1));
+    auto [visible, scenic_score] = solve(input);
 
     std::cout << header(8, title);
-    std::cout << "  part 1: " << num_visible(input) << "\n";
-    std::cout << "  part 2: " << highest_scenic_score(input) << "\n";
+    std::cout << "  part 1: " << visible << "\n";
+    std::cout << "  part 2: " << scenic_score << "\n";
 }
\ No newline at end of file
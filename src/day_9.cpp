@@ -1,11 +1,12 @@
 #include "util.h"
 #include "days.h"
+#include "small_vector.h"
 #include <range/v3/all.hpp>
 #include <iostream>
 #include <filesystem>
 #include <functional>
 #include <tuple>
-#include <unordered_map>
+#include <array>
 #include <unordered_set>
 #include <sstream>
 #include <boost/functional/hash.hpp>
@@ -48,14 +49,20 @@ namespace {
         return (T(0) < val) - (val < T(0));
     }
 
-    using rope = std::vector<point>;
+    using rope = aoc::small_vector<point, 10>;
     using movement = std::tuple<char, int>;
 
+    constexpr auto dir_to_delta = [] {
+        std::array<point, 256> tbl = {};
+        tbl['U'] = { 0,1 };
+        tbl['R'] = { 1,0 };
+        tbl['D'] = { 0,-1 };
+        tbl['L'] = { -1,0 };
+        return tbl;
+    }();
+
     point move_head(const point& head, char dir) {
-        const static std::unordered_map<char, point> dir_to_delta = {
-            {'U', {0,1}}, {'R', {1,0}}, {'D', {0,-1}}, {'L', {-1,0}}
-        };
-        return head + dir_to_delta.at(dir);
+        return head + dir_to_delta[static_cast<unsigned char>(dir)];
     }
 
     point move_knot(const point& prev, const point& link) {
@@ -65,31 +72,26 @@ namespace {
             link + point{ sgn(delta.x), sgn(delta.y) };
     }
 
+    // each knot follows the new position of the one in front of it; a dummy head two steps
+    // ahead drags the real head one step.
     rope move_rope(const rope& r, char direction) {
-        auto dummy_head = move_head(move_head(r.front(), direction), direction);
-        return rv::concat(rv::single(dummy_head), rv::all(r)) |
-            rv::partial_sum(move_knot) | rv::drop(1) | r::to_vector;
-    }
-
-    /* 
-    * 
-    // non-range version below...
-    
-    rope move_rope(const rope& r, char direction) {
-        rope new_rope(r.size());
-        for (int i = 0; i < r.size(); ++i) {
-            new_rope[i] = (i > 0) ?
-                move_link(new_rope[i - 1], r[i]):
-                move_head(r[0], direction);
+        rope new_rope;
+        auto prev = move_head(move_head(r.front(), direction), direction);
+        for (const auto& link : r) {
+            prev = move_knot(prev, link);
+            new_rope.push_back(prev);
         }
         return new_rope;
     }
-    
-    */
 
     movement parse_line_of_input(const std::string& line) {
         auto pieces = aoc::split(line, ' ');
-        return {pieces[0][0], std::stoi(pieces[1])};
+        // anything but U, R, D or L would look up a zero move
+        auto dir = pieces[0][0];
+        if (pieces[0].size() != 1 || dir_to_delta[static_cast<unsigned char>(dir)] == point{ 0,0 }) {
+            throw std::runtime_error("unknown direction: " + pieces[0]);
+        }
+        return {dir, std::stoi(pieces[1])};
     }
 
     int unique_tail_positions(const auto& moves, int length_of_rope) {
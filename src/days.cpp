@@ -2,6 +2,7 @@
 #include <string>
 #include <sstream>
 #include <filesystem>
+#include <cstdlib>
 
 /*------------------------------------------------------------------------------------------------*/
 
@@ -17,7 +18,12 @@ std::string aoc::input_path(int day, std::optional<int> part) {
     std::string fname = file_prefix + "_" +
         std::to_string(day) + "_" +
         part_tag + ".txt";
-    fs::path inp_path = fs::current_path() / input_dir / fname;
+    // AOC_INPUT_DIR points the days at another set of inputs, e.g. generated ones
+    const char* dir_override = std::getenv("AOC_INPUT_DIR");
+    fs::path dir = (dir_override && *dir_override) ?
+        fs::path(dir_override) :
+        fs::current_path() / input_dir;
+    fs::path inp_path = dir / fname;
     return inp_path.string();
 }
 
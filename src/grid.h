@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*------------------------------------------------------------------------------------------------*/
+
+// a flat, row-major 2D grid whose width and height may each be fixed at compile time. with a
+// fixed width the index math folds to constants and row() returns a fixed-extent span, so loops
+// over a row can be unrolled; with both extents fixed the cells live in a std::array, which means
+// on the stack for a local grid, so static extents are meant for small grids.
+//
+// with_extent / with_grid pick, at run time, the first of a short list of compile-time extents
+// that matches a parsed input and fall back to dynamic extents otherwise. the callback is
+// instantiated once per listed extent plus once for the fallback.
+
+namespace aoc {
+
+    inline constexpr int dynamic_extent = -1;
+
+    template <typename T, int W = dynamic_extent, int H = dynamic_extent>
+    class grid {
+        static constexpr bool k_is_static = W != dynamic_extent && H != dynamic_extent;
+        static constexpr size_t k_row_extent =
+            (W == dynamic_extent) ? std::dynamic_extent : static_cast<size_t>(W);
+
+        using storage = std::conditional_t<
+            k_is_static,
+            std::array<T, k_is_static ? static_cast<size_t>(W) * H : 0>,
+            std::vector<T>
+        >;
+
+        int wd_;
+        int hgt_;
+        storage cells_;
+
+    public:
+        grid(int wd = (W == dynamic_extent) ? 0 : W, int hgt = (H == dynamic_extent) ? 0 : H,
+                const T& val = T{}) :
+            wd_(wd),
+            hgt_(hgt)
+        {
+            if ((W != dynamic_extent && wd != W) || (H != dynamic_extent && hgt != H)) {
+                throw std::runtime_error("grid: extents do not match the static extents");
+            }
+            if constexpr (k_is_static) {
+                cells_.fill(val);
+            } else {
+                cells_.assign(static_cast<size_t>(wd) * hgt, val);
+            }
+        }
+
+        constexpr int width() const {
+            if constexpr (W != dynamic_extent) {
+                return W;
+            } else {
+                return wd_;
+            }
+        }
+
+        constexpr int height() const {
+            if constexpr (H != dynamic_extent) {
+                return H;
+            } else {
+                return hgt_;
+            }
+        }
+
+        size_t size() const {
+            return cells_.size();
+        }
+
+        bool contains(int x, int y) const {
+            return x >= 0 && x < width() && y >= 0 && y < height();
+        }
+
+        T& operator()(int x, int y) {
+            return cells_[static_cast<size_t>(y) * width() + x];
+        }
+
+        const T& operator()(int x, int y) const {
+            return cells_[static_cast<size_t>(y) * width() + x];
+        }
+
+        std::span<T, k_row_extent> row(int y) {
+            return std::span<T, k_row_extent>(cells_.data() + static_cast<size_t>(y) * width(), width());
+        }
+
+        std::span<const T, k_row_extent> row(int y) const {
+            return std::span<const T, k_row_extent>(cells_.data() + static_cast<size_t>(y) * width(), width());
+        }
+
+        void fill(const T& val) {
+            std::fill(cells_.begin(), cells_.end(), val);
+        }
+
+        T* data() {
+            return cells_.data();
+        }
+
+        const T* data() const {
+            return cells_.data();
+        }
+
+        auto begin() { return cells_.begin(); }
+        auto end() { return cells_.end(); }
+        auto begin() const { return cells_.begin(); }
+        auto end() const { return cells_.end(); }
+    };
+
+    struct extent {
+        int wd;
+        int hgt;
+    };
+
+    namespace detail {
+        template <typename F>
+        decltype(auto) with_extent_impl(int, int, F& f) {
+            return f(
+                std::integral_constant<int, dynamic_extent>{},
+                std::integral_constant<int, dynamic_extent>{}
+            );
+        }
+
+        template <extent E, extent... Es, typename F>
+        decltype(auto) with_extent_impl(int wd, int hgt, F& f) {
+            if (wd == E.wd && hgt == E.hgt) {
+                return f(
+                    std::integral_constant<int, E.wd>{},
+                    std::integral_constant<int, E.hgt>{}
+                );
+            }
+            return with_extent_impl<Es...>(wd, hgt, f);
+        }
+    }
+
+    // calls f(w, h) where w and h are std::integral_constant<int, ...>: the first of Es equal to
+    // wd x hgt, or dynamic_extent twice if there is none. every instantiation of f must return
+    // the same type.
+    template <extent... Es, typename F>
+    decltype(auto) with_extent(int wd, int hgt, F&& f) {
+        return detail::with_extent_impl<Es...>(wd, hgt, f);
+    }
+
+    // calls f with a default-filled grid<T, W, H> of size wd x hgt, using static extents when one
+    // of Es matches.
+    template <typename T, extent... Es, typename F>
+    decltype(auto) with_grid(int wd, int hgt, F&& f) {
+        return with_extent<Es...>(wd, hgt,
+            [&](auto w, auto h) -> decltype(auto) {
+                return f(grid<T, decltype(w)::value, decltype(h)::value>(wd, hgt));
+            }
+        );
+    }
+}
@@ -0,0 +1,35 @@
+#include "interner.h"
+#include <stdexcept>
+
+/*------------------------------------------------------------------------------------------------*/
+
+int aoc::interner::intern(std::string_view name) {
+    auto iter = ids_.find(name);
+    if (iter != ids_.end()) {
+        return iter->second;
+    }
+    int id = static_cast<int>(names_.size());
+    names_.emplace_back(name);
+    ids_.emplace(names_.back(), id);
+    return id;
+}
+
+int aoc::interner::id(std::string_view name) const {
+    auto iter = ids_.find(name);
+    if (iter == ids_.end()) {
+        throw std::runtime_error("unknown name: " + std::string(name));
+    }
+    return iter->second;
+}
+
+bool aoc::interner::contains(std::string_view name) const {
+    return ids_.find(name) != ids_.end();
+}
+
+const std::string& aoc::interner::name(int id) const {
+    return names_.at(id);
+}
+
+int aoc::interner::size() const {
+    return static_cast<int>(names_.size());
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/*------------------------------------------------------------------------------------------------*/
+
+// a symbol table for days whose input names things by label: each distinct name gets a dense
+// integer id, 0, 1, 2, ... in order of first appearance, so that parsing can turn names into
+// indices and the solving code can work on vectors instead of string-keyed maps.
+
+namespace aoc {
+
+    class interner {
+        struct string_hash {
+            using is_transparent = void;
+            size_t operator()(std::string_view str) const {
+                return std::hash<std::string_view>{}(str);
+            }
+        };
+
+        std::unordered_map<std::string, int, string_hash, std::equal_to<>> ids_;
+        std::vector<std::string> names_;
+
+    public:
+        // the id of name, assigning the next id if it has not been seen
+        int intern(std::string_view name);
+
+        // the id of a name that has already been interned; throws if it has not
+        int id(std::string_view name) const;
+
+        bool contains(std::string_view name) const;
+        const std::string& name(int id) const;
+        int size() const;
+    };
+}
@@ -1,6 +1,12 @@
 #include "days.h"
+#include "checkpoint.h"
+#include "counters.h"
+#include "profiler.h"
+#include "simd_check.h"
+#include "table_bench.h"
 #include "util.h"
 #include <iostream>
+#include <optional>
 #include <vector>
 #include <functional>
 #include <string>
@@ -44,6 +50,9 @@ namespace {
 
         if (index < advent_of_code_2022.size()) {
             advent_of_code_2022[index]();
+#ifdef AOC_ENABLE_COUNTERS
+            aoc::counters::report(std::cout);
+#endif
         } else {
             std::cout << "Day " << day << " is not complete.\n";
         }
@@ -58,6 +67,14 @@ int main(int argc, char* argv[]) {
         return -1;
     }
     std::string day = argv[1];
+    // "simd" checks and times the simd kernels instead of running a day
+    if (day == "simd") {
+        return (aoc::simd_check::run(std::cout) == 0) ? 0 : 1;
+    }
+    // "tables" checks and times the constexpr lookup tables against the maps they replaced
+    if (day == "tables") {
+        return (aoc::table_bench::run(std::cout) == 0) ? 0 : 1;
+    }
     if (!aoc::is_number(argv[1])) {
         std::cout << "invalid day: " << day << "\n";
         return -1;
@@ -68,6 +85,53 @@ int main(int argc, char* argv[]) {
         return -1;
     }
 
-    return do_advent_of_code_2022(day_number);
+    // --profile samples the run and writes folded stacks to day_N.folded, or to --profile=path.
+    // --checkpoint snapshots long simulations into ./checkpoints every 30 seconds, or every
+    // --checkpoint=seconds, and --resume continues from those snapshots.
+    std::optional<std::string> profile_path;
+    std::optional<double> checkpoint_interval;
+    bool resume = false;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--profile") {
+            profile_path = "day_" + day + ".folded";
+        } else if (arg.starts_with("--profile=")) {
+            profile_path = arg.substr(std::string("--profile=").size());
+        } else if (arg == "--checkpoint") {
+            checkpoint_interval = 30.0;
+        } else if (arg.starts_with("--checkpoint=")) {
+            auto seconds = arg.substr(std::string("--checkpoint=").size());
+            if (!aoc::is_number(seconds) || std::stoi(seconds) < 1) {
+                std::cout << "invalid checkpoint interval: " << seconds << "\n";
+                return -1;
+            }
+            checkpoint_interval = std::stoi(seconds);
+        } else if (arg == "--resume") {
+            resume = true;
+        } else {
+            std::cout << "unknown option: " << arg << "\n";
+            return -1;
+        }
+    }
+    if (checkpoint_interval || resume) {
+        aoc::checkpoint::configure("checkpoints", checkpoint_interval.value_or(30.0), resume);
+    }
+    if (!profile_path) {
+        return do_advent_of_code_2022(day_number);
+    }
+
+    if (!aoc::profiler::is_supported()) {
+        std::cout << "--profile is not supported on this platform\n";
+        return -1;
+    }
+    aoc::profiler::start();
+    auto result = do_advent_of_code_2022(day_number);
+    auto samples = aoc::profiler::stop(*profile_path);
+    std::cerr << "profile: " << samples << " samples written to " << *profile_path;
+    if (auto dropped = aoc::profiler::dropped()) {
+        std::cerr << ", " << dropped << " dropped";
+    }
+    std::cerr << "\n";
+    return result;
 }
 
@@ -11,6 +11,7 @@
 #include <any>
 #include <cassert>
 #include <cctype>
+#include <chrono>
 #if __has_include(<charconv>)
 #include <charconv>
 #endif
@@ -779,6 +780,19 @@ private:
   }
 };
 
+/*
+ * Rule profiling
+ */
+struct RuleStats {
+  size_t invocations = 0;
+  size_t successes = 0;
+  size_t backtracks = 0; // invocations that failed, sending the caller elsewhere
+  size_t actions = 0;
+  // inclusive of sub-rules, so time in a recursive rule is counted once per level
+  std::chrono::steady_clock::duration time{};
+  std::chrono::steady_clock::duration action_time{}; // in semantic actions
+};
+
 /*
  * Context
  */
@@ -1502,12 +1516,23 @@ public:
     c.in_whitespace = true;
     auto se = scope_exit([&]() { c.in_whitespace = false; });
     const auto &rule = *ope_;
-    return rule.parse(s, n, vs, c, dt);
+    if (!stats_) { return rule.parse(s, n, vs, c, dt); }
+    auto start = std::chrono::steady_clock::now();
+    auto len = rule.parse(s, n, vs, c, dt);
+    stats_->invocations++;
+    if (success(len)) {
+      stats_->successes++;
+    } else {
+      stats_->backtracks++;
+    }
+    stats_->time += std::chrono::steady_clock::now() - start;
+    return len;
   }
 
   void accept(Visitor &v) override;
 
   std::shared_ptr<Ope> ope_;
+  std::shared_ptr<RuleStats> stats_;
 };
 
 class BackReference : public Ope {
@@ -2369,6 +2394,7 @@ public:
   std::vector<std::string> params;
   TracerEnter tracer_enter;
   TracerLeave tracer_leave;
+  std::shared_ptr<RuleStats> stats;
   bool disable_action = false;
 
   std::string error_message;
@@ -2590,6 +2616,10 @@ inline size_t Holder::parse_core(const char *s, size_t n, SemanticValues &vs,
   size_t len;
   std::any val;
 
+  auto stats = outer_->stats.get();
+  auto start = stats ? std::chrono::steady_clock::now()
+                     : std::chrono::steady_clock::time_point{};
+
   c.packrat(s, outer_->id, len, val, [&](std::any &a_val) {
     if (outer_->enter) { outer_->enter(s, n, dt); }
 
@@ -2637,11 +2667,28 @@ inline size_t Holder::parse_core(const char *s, size_t n, SemanticValues &vs,
     }
   }
 
+  if (stats) {
+    stats->invocations++;
+    if (success(len)) {
+      stats->successes++;
+    } else {
+      stats->backtracks++;
+    }
+    stats->time += std::chrono::steady_clock::now() - start;
+  }
+
   return len;
 }
 
 inline std::any Holder::reduce(SemanticValues &vs, std::any &dt) const {
   if (outer_->action && !outer_->disable_action) {
+    if (auto stats = outer_->stats.get()) {
+      auto start = std::chrono::steady_clock::now();
+      auto val = outer_->action(vs, dt);
+      stats->actions++;
+      stats->action_time += std::chrono::steady_clock::now() - start;
+      return val;
+    }
     return outer_->action(vs, dt);
   } else if (vs.empty()) {
     return std::any();
@@ -4272,6 +4319,29 @@ public:
     }
   }
 
+  // counts invocations, successes, backtracks and time for every rule, and for
+  // %whitespace, plus calls and time in the semantic actions; see profile()
+  void enable_profiling() {
+    if (grammar_ == nullptr) { return; }
+    for (auto &[_, rule] : *grammar_) {
+      rule.stats = std::make_shared<RuleStats>();
+    }
+    auto &start = (*grammar_)[start_];
+    if (auto wsp = std::dynamic_pointer_cast<Whitespace>(start.whitespaceOpe)) {
+      wsp->stats_ = (*grammar_)[WHITESPACE_DEFINITION_NAME].stats;
+    }
+  }
+
+  // the stats of the rules that have been invoked, by rule name
+  std::map<std::string, RuleStats> profile() const {
+    std::map<std::string, RuleStats> stats;
+    if (grammar_ == nullptr) { return stats; }
+    for (const auto &[name, rule] : *grammar_) {
+      if (rule.stats && rule.stats->invocations > 0) { stats[name] = *rule.stats; }
+    }
+    return stats;
+  }
+
   template <typename T = Ast> parser &enable_ast() {
     for (auto &[_, rule] : *grammar_) {
       if (!rule.action) { add_ast_action<T>(rule); }
@@ -0,0 +1,374 @@
+#include "profiler.h"
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <sys/time.h>
+#ifdef __linux__
+#include <elf.h>
+#endif
+#endif
+
+/*------------------------------------------------------------------------------------------------*/
+
+#ifdef _WIN32
+
+bool aoc::profiler::is_supported() {
+    return false;
+}
+
+void aoc::profiler::start(int hz) {
+    throw std::runtime_error("the profiler needs SIGPROF and is not available on this platform");
+}
+
+size_t aoc::profiler::stop(const std::string& path) {
+    return 0;
+}
+
+size_t aoc::profiler::dropped() {
+    return 0;
+}
+
+#else
+
+namespace {
+
+    // deep enough for most range-v3 stacks; a deeper stack keeps its innermost frames and is
+    // folded under a [truncated] root rather than under whatever frame happened to be outermost
+    constexpr int k_max_depth = 128;
+
+    // the signal handler and the trampoline that called it
+    constexpr int k_handler_frames = 2;
+
+    struct sample {
+        int depth;
+        void* frames[k_max_depth];
+    };
+
+    // the handler cannot allocate, so samples go in chunks of about a megabyte that a helper
+    // thread allocates a few ahead of the one being filled. a sample that finds its chunk not yet
+    // there, or that comes after the last chunk, is dropped and counted.
+    constexpr size_t k_chunk_samples = 1024;
+    constexpr size_t k_max_chunks = 1024;
+    constexpr size_t k_spare_chunks = 2;
+
+    // written from the signal handler, so nothing here may allocate or lock once sampling starts
+    std::array<std::atomic<sample*>, k_max_chunks> chunks;
+    std::atomic<size_t> next_sample = 0;
+    std::atomic<size_t> dropped_samples = 0;
+    std::atomic<int> handlers_running = 0;
+    std::atomic<bool> sampling = false;
+
+    // owned by the allocator thread while sampling
+    std::vector<std::unique_ptr<sample[]>> allocated_chunks;
+    std::thread chunk_allocator;
+
+    void on_sigprof(int) {
+        ++handlers_running;
+        if (sampling.load(std::memory_order_relaxed)) {
+            auto saved_errno = errno;
+            auto i = next_sample.fetch_add(1, std::memory_order_relaxed);
+            auto chunk = (i / k_chunk_samples < k_max_chunks) ?
+                chunks[i / k_chunk_samples].load(std::memory_order_acquire) : nullptr;
+            if (chunk) {
+                auto& s = chunk[i % k_chunk_samples];
+                s.depth = backtrace(s.frames, k_max_depth);
+            } else {
+                dropped_samples.fetch_add(1, std::memory_order_relaxed);
+            }
+            errno = saved_errno;
+        }
+        --handlers_running;
+    }
+
+    // allocates chunks, in order, up to k_spare_chunks past the one being filled
+    void allocate_chunks() {
+        auto wanted = std::min(
+            next_sample.load(std::memory_order_relaxed) / k_chunk_samples + 1 + k_spare_chunks,
+            k_max_chunks
+        );
+        while (allocated_chunks.size() < wanted) {
+            // value-initialised, so that a slot no sample reached has depth 0 and is skipped
+            allocated_chunks.push_back(std::make_unique<sample[]>(k_chunk_samples));
+            chunks[allocated_chunks.size() - 1].store(
+                allocated_chunks.back().get(), std::memory_order_release
+            );
+        }
+    }
+
+    void set_timer(int hz) {
+        itimerval timer = {};
+        if (hz > 0) {
+            timer.it_interval.tv_usec = 1000000 / hz;
+            timer.it_value = timer.it_interval;
+        }
+        setitimer(ITIMER_PROF, &timer, nullptr);
+    }
+
+    // drops return types, template argument lists and parameter lists, keeping operator names
+    std::string shorten(const std::string& name) {
+        static const std::string anonymous = "(anonymous namespace)";
+        std::string out;
+        int angle_depth = 0;
+        int paren_depth = 0;
+        for (size_t i = 0; i < name.size(); ++i) {
+            if (name.compare(i, anonymous.size(), anonymous) == 0) {
+                if (angle_depth == 0 && paren_depth == 0) {
+                    out += anonymous;
+                }
+                i += anonymous.size() - 1;
+                continue;
+            }
+            if (name.compare(i, 8, "operator") == 0) {
+                auto j = i + 8;
+                if (name.compare(j, 2, "()") == 0 || name.compare(j, 2, "[]") == 0) {
+                    j += 2;
+                } else if (j < name.size() && name[j] == ' ') {
+                    // a conversion operator, named by its type
+                    j = name.find('(', j);
+                    j = (j == std::string::npos) ? name.size() : j;
+                } else {
+                    while (j < name.size() && std::strchr("<>=!+-*/%&|^~,", name[j])) {
+                        ++j;
+                    }
+                }
+                if (angle_depth == 0 && paren_depth == 0) {
+                    out += name.substr(i, j - i);
+                }
+                i = j - 1;
+                continue;
+            }
+            char ch = name[i];
+            if (ch == '<') {
+                ++angle_depth;
+            } else if (ch == '>' && angle_depth > 0) {
+                --angle_depth;
+            } else if (ch == '(') {
+                ++paren_depth;
+            } else if (ch == ')' && paren_depth > 0) {
+                --paren_depth;
+            } else if (angle_depth == 0 && paren_depth == 0) {
+                if (ch == ' ') {
+                    // either the end of a return type, or qualifiers after the parameter list
+                    if (name.compare(i + 1, 5, "const") == 0 || name.compare(i + 1, 1, "&") == 0) {
+                        break;
+                    }
+                    out.clear();
+                    continue;
+                }
+                out += (ch == ';') ? ':' : ch;
+            }
+        }
+        return out;
+    }
+
+    struct function_symbol {
+        uintptr_t start;
+        uintptr_t end;
+        std::string name;
+    };
+
+    // the functions in a module's static symbol table, sorted by address. dladdr only sees
+    // exported symbols, which leaves out everything in an anonymous namespace, i.e. nearly all of
+    // the solutions; the static table has them unless the binary was stripped.
+    std::vector<function_symbol> read_symbol_table(const std::string& path, uintptr_t base) {
+        std::vector<function_symbol> symbols;
+#ifdef __linux__
+        std::ifstream in(path, std::ios::binary);
+        std::string image((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        if (image.size() < sizeof(Elf64_Ehdr) || image.compare(0, 4, ELFMAG) != 0 ||
+                image[EI_CLASS] != ELFCLASS64) {
+            return symbols;
+        }
+        auto header = reinterpret_cast<const Elf64_Ehdr*>(image.data());
+        if (header->e_shoff + header->e_shnum * sizeof(Elf64_Shdr) > image.size()) {
+            return symbols;
+        }
+        // position independent code is relocated by the load address; fixed executables are not
+        auto offset = (header->e_type == ET_DYN) ? base : 0;
+        auto sections = reinterpret_cast<const Elf64_Shdr*>(image.data() + header->e_shoff);
+        for (int i = 0; i < header->e_shnum; ++i) {
+            const auto& section = sections[i];
+            if (section.sh_type != SHT_SYMTAB || section.sh_link >= header->e_shnum) {
+                continue;
+            }
+            const auto& strings = sections[section.sh_link];
+            if (section.sh_offset + section.sh_size > image.size() ||
+                    strings.sh_offset + strings.sh_size > image.size()) {
+                continue;
+            }
+            auto syms = reinterpret_cast<const Elf64_Sym*>(image.data() + section.sh_offset);
+            for (size_t j = 0; j < section.sh_size / sizeof(Elf64_Sym); ++j) {
+                const auto& sym = syms[j];
+                if (ELF64_ST_TYPE(sym.st_info) != STT_FUNC || sym.st_value == 0 ||
+                        sym.st_name >= strings.sh_size) {
+                    continue;
+                }
+                symbols.push_back({
+                    sym.st_value + offset,
+                    sym.st_value + offset + std::max<uintptr_t>(sym.st_size, 1),
+                    image.data() + strings.sh_offset + sym.st_name
+                });
+            }
+        }
+        std::sort(symbols.begin(), symbols.end(),
+            [](const auto& lhs, const auto& rhs) { return lhs.start < rhs.start; });
+#endif
+        return symbols;
+    }
+
+    const char* static_symbol(const Dl_info& info, void* addr) {
+        static std::unordered_map<std::string, std::vector<function_symbol>> modules;
+        auto iter = modules.find(info.dli_fname);
+        if (iter == modules.end()) {
+            auto base = reinterpret_cast<uintptr_t>(info.dli_fbase);
+            iter = modules.emplace(info.dli_fname, read_symbol_table(info.dli_fname, base)).first;
+        }
+        const auto& symbols = iter->second;
+        auto pc = reinterpret_cast<uintptr_t>(addr);
+        auto next = std::upper_bound(symbols.begin(), symbols.end(), pc,
+            [](uintptr_t pc, const auto& sym) { return pc < sym.start; });
+        if (next == symbols.begin() || pc >= std::prev(next)->end) {
+            return nullptr;
+        }
+        return std::prev(next)->name.c_str();
+    }
+
+    std::string frame_name(void* addr) {
+        Dl_info info = {};
+        if (!dladdr(addr, &info)) {
+            std::stringstream ss;
+            ss << addr;
+            return ss.str();
+        }
+        const char* symbol = info.dli_fname ? static_symbol(info, addr) : nullptr;
+        if (!symbol) {
+            symbol = info.dli_sname;
+        }
+        if (symbol) {
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(symbol, nullptr, nullptr, &status);
+            std::string name = (status == 0 && demangled) ? demangled : symbol;
+            std::free(demangled);
+            return shorten(name);
+        }
+        std::stringstream ss;
+        if (info.dli_fname) {
+            std::string module = info.dli_fname;
+            ss << module.substr(module.find_last_of('/') + 1) << "+0x" << std::hex <<
+                (reinterpret_cast<uintptr_t>(addr) - reinterpret_cast<uintptr_t>(info.dli_fbase));
+        } else {
+            ss << addr;
+        }
+        return ss.str();
+    }
+}
+
+bool aoc::profiler::is_supported() {
+    return true;
+}
+
+void aoc::profiler::start(int hz) {
+    if (hz <= 0 || hz > 1000000) {
+        throw std::runtime_error("profiler: bad sampling rate");
+    }
+    for (auto& chunk : chunks) {
+        chunk = nullptr;
+    }
+    allocated_chunks.clear();
+    next_sample = 0;
+    dropped_samples = 0;
+    allocate_chunks();
+
+    // the first call to backtrace may load the unwinder, which is not safe in a signal handler
+    void* warm_up[1];
+    backtrace(warm_up, 1);
+
+    struct sigaction action = {};
+    action.sa_handler = on_sigprof;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGPROF, &action, nullptr);
+
+    sampling = true;
+    chunk_allocator = std::thread(
+        [] {
+            while (sampling) {
+                allocate_chunks();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    );
+    set_timer(hz);
+}
+
+size_t aoc::profiler::stop(const std::string& path) {
+    sampling = false;
+    set_timer(0);
+    // a SIGPROF still in flight must not find the default action, which ends the process
+    std::signal(SIGPROF, SIG_IGN);
+    while (handlers_running > 0) {
+        std::this_thread::yield();
+    }
+    chunk_allocator.join();
+
+    auto n = std::min(next_sample.load(), allocated_chunks.size() * k_chunk_samples);
+    std::unordered_map<void*, std::string> names;
+    std::map<std::string, size_t> folded;
+    for (size_t i = 0; i < n; ++i) {
+        const auto& s = allocated_chunks[i / k_chunk_samples][i % k_chunk_samples];
+        std::string stack = (s.depth == k_max_depth) ? "[truncated]" : "";
+        for (int j = s.depth - 1; j >= k_handler_frames; --j) {
+            // return addresses point just past the call; the interrupted frame's pc does not
+            auto addr = (j == k_handler_frames) ?
+                s.frames[j] :
+                static_cast<void*>(static_cast<char*>(s.frames[j]) - 1);
+            auto iter = names.find(addr);
+            if (iter == names.end()) {
+                iter = names.emplace(addr, frame_name(addr)).first;
+            }
+            if (!stack.empty()) {
+                stack += ';';
+            }
+            stack += iter->second;
+        }
+        if (!stack.empty()) {
+            ++folded[stack];
+        }
+    }
+
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("profiler: unable to write " + path);
+    }
+    for (const auto& [stack, count] : folded) {
+        out << stack << ' ' << count << '\n';
+    }
+    allocated_chunks.clear();
+    return next_sample - dropped_samples;
+}
+
+size_t aoc::profiler::dropped() {
+    return dropped_samples;
+}
+
+#endif
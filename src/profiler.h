@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/*------------------------------------------------------------------------------------------------*/
+
+// an in-process sampling profiler behind main's --profile option. while running it takes a stack
+// sample of whichever thread is on the cpu every 1/hz seconds of process cpu time, using SIGPROF
+// and the platform unwinder, and on stopping writes the samples as folded stacks,
+//
+//     main;aoc::day_16;(anonymous namespace)::do_traversal;... 42
+//
+// one line per distinct stack, root first, which flamegraph.pl or speedscope render directly.
+// return types and template argument and parameter lists are dropped from the frame names so
+// that range-v3 pipelines stay readable. frames are named from the modules' static symbol tables
+// on linux and from the exported symbols elsewhere, falling back to module+offset, so a stripped
+// build only shows offsets. POSIX only; elsewhere start() throws.
+
+namespace aoc::profiler {
+
+    bool is_supported();
+
+    void start(int hz = 997);
+
+    // stops sampling, writes the folded stacks to path and returns the number of samples
+    size_t stop(const std::string& path);
+
+    // the number of samples the last run had no room for, which stop did not write
+    size_t dropped();
+}
@@ -0,0 +1,292 @@
+#pragma once
+
+#include "counters.h"
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/*------------------------------------------------------------------------------------------------*/
+
+// a small search framework: bfs, dfs, best-first and A* share one loop and differ only in
+// the frontier they use. a search problem is any type with
+//
+//     void successors(const State& s, auto&& emit);  // call emit(next) for each next state
+//
+// and, optionally,
+//
+//     bool is_goal(const State& s);   // the search returns the first goal state it pops
+//     uint64_t key(const State& s);   // packed state; states whose key was seen are skipped
+//     bool prune(const State& s);     // true means do not expand s
+//     int64_t priority(const State& s);                            // best-first
+//     int64_t cost(const State& s); int64_t heuristic(const State& s); // A*
+//
+// each popped state goes through is_goal, then the key check, then prune, then expansion.
+// states live in a recycled pool and the frontiers only move 32-bit slot indices around.
+
+namespace aoc::search {
+
+    struct options {
+        // 0 means an exact, unbounded set of seen keys. any other value gives a direct-mapped
+        // table of that many slots that forgets on collision: it can cause re-expansion but
+        // never skips a state that was not seen.
+        size_t transposition_capacity = 0;
+    };
+
+    struct counting_hooks {
+        void on_push() { AOC_COUNT(states_pushed); }
+        void on_pop() { AOC_COUNT(states_popped); }
+        void on_duplicate() { AOC_COUNT(states_duplicate); }
+        void on_prune() { AOC_COUNT(states_pruned); }
+    };
+
+    template <typename State>
+    class state_pool {
+        std::vector<State> slots_;
+        std::vector<uint32_t> free_;
+    public:
+        uint32_t store(State&& state) {
+            if (!free_.empty()) {
+                auto index = free_.back();
+                free_.pop_back();
+                slots_[index] = std::move(state);
+                return index;
+            }
+            slots_.push_back(std::move(state));
+            return static_cast<uint32_t>(slots_.size() - 1);
+        }
+
+        State take(uint32_t index) {
+            free_.push_back(index);
+            return std::move(slots_[index]);
+        }
+    };
+
+    class transposition_table {
+        std::unordered_set<uint64_t> exact_;
+        std::vector<uint64_t> keys_;
+        std::vector<bool> used_;
+
+        static uint64_t mix(uint64_t key) {
+            key ^= key >> 30;
+            key *= 0xbf58476d1ce4e5b9ull;
+            key ^= key >> 27;
+            key *= 0x94d049bb133111ebull;
+            return key ^ (key >> 31);
+        }
+
+    public:
+        explicit transposition_table(size_t capacity = 0) :
+            keys_(capacity),
+            used_(capacity, false)
+        {}
+
+        // returns false if the key has already been seen
+        bool insert(uint64_t key) {
+            if (keys_.empty()) {
+                return exact_.insert(key).second;
+            }
+            auto slot = mix(key) % keys_.size();
+            if (used_[slot] && keys_[slot] == key) {
+                return false;
+            }
+            used_[slot] = true;
+            keys_[slot] = key;
+            return true;
+        }
+    };
+
+    namespace frontier {
+
+        class lifo {
+            std::vector<uint32_t> items_;
+        public:
+            void push(uint32_t index, int64_t) {
+                items_.push_back(index);
+            }
+
+            uint32_t pop() {
+                auto index = items_.back();
+                items_.pop_back();
+                return index;
+            }
+
+            bool empty() const {
+                return items_.empty();
+            }
+        };
+
+        class fifo {
+            std::vector<uint32_t> items_;
+            size_t head_ = 0;
+        public:
+            void push(uint32_t index, int64_t) {
+                items_.push_back(index);
+            }
+
+            uint32_t pop() {
+                auto index = items_[head_++];
+                if (head_ == items_.size()) {
+                    items_.clear();
+                    head_ = 0;
+                } else if (head_ >= 4096 && 2 * head_ >= items_.size()) {
+                    items_.erase(items_.begin(), items_.begin() + head_);
+                    head_ = 0;
+                }
+                return index;
+            }
+
+            bool empty() const {
+                return head_ == items_.size();
+            }
+        };
+
+        // ties are broken by insertion order so results do not depend on heap internals
+        class min_priority {
+            struct entry {
+                int64_t priority;
+                uint64_t seq;
+                uint32_t index;
+
+                bool operator>(const entry& e) const {
+                    return (priority != e.priority) ? priority > e.priority : seq > e.seq;
+                }
+            };
+            std::priority_queue<entry, std::vector<entry>, std::greater<entry>> heap_;
+            uint64_t seq_ = 0;
+        public:
+            void push(uint32_t index, int64_t priority) {
+                heap_.push({ priority, seq_++, index });
+            }
+
+            uint32_t pop() {
+                auto index = heap_.top().index;
+                heap_.pop();
+                return index;
+            }
+
+            bool empty() const {
+                return heap_.empty();
+            }
+        };
+    }
+
+    template <typename P, typename S>
+    concept has_goal = requires(P & p, const S & s) { { p.is_goal(s) } -> std::convertible_to<bool>; };
+
+    template <typename P, typename S>
+    concept has_key = requires(P & p, const S & s) { { p.key(s) } -> std::convertible_to<uint64_t>; };
+
+    template <typename P, typename S>
+    concept has_prune = requires(P & p, const S & s) { { p.prune(s) } -> std::convertible_to<bool>; };
+
+    namespace detail {
+
+        template <typename Frontier, typename Problem, typename State, typename Priority, typename Hooks>
+        std::optional<State> run(Problem& problem, std::vector<State> initial, Priority priority,
+                const options& opts, Hooks& hooks) {
+            state_pool<State> pool;
+            Frontier frontier;
+            transposition_table seen(opts.transposition_capacity);
+
+            auto push = [&](State next) {
+                auto p = priority(next);
+                frontier.push(pool.store(std::move(next)), p);
+                hooks.on_push();
+            };
+            for (auto& state : initial) {
+                push(std::move(state));
+            }
+
+            while (!frontier.empty()) {
+                State state = pool.take(frontier.pop());
+                hooks.on_pop();
+
+                if constexpr (has_goal<Problem, State>) {
+                    if (problem.is_goal(state)) {
+                        return state;
+                    }
+                }
+                if constexpr (has_key<Problem, State>) {
+                    if (!seen.insert(problem.key(state))) {
+                        hooks.on_duplicate();
+                        continue;
+                    }
+                }
+                if constexpr (has_prune<Problem, State>) {
+                    if (problem.prune(state)) {
+                        hooks.on_prune();
+                        continue;
+                    }
+                }
+                problem.successors(state, push);
+            }
+            return {};
+        }
+
+        template <typename State>
+        int64_t no_priority(const State&) {
+            return 0;
+        }
+    }
+
+    template <typename Problem, typename State, typename Hooks = counting_hooks>
+    std::optional<State> bfs(Problem& problem, std::vector<State> initial,
+            const options& opts = {}, Hooks hooks = {}) {
+        return detail::run<frontier::fifo>(
+            problem, std::move(initial), detail::no_priority<State>, opts, hooks
+        );
+    }
+
+    template <typename Problem, typename State, typename Hooks = counting_hooks>
+    std::optional<State> dfs(Problem& problem, std::vector<State> initial,
+            const options& opts = {}, Hooks hooks = {}) {
+        return detail::run<frontier::lifo>(
+            problem, std::move(initial), detail::no_priority<State>, opts, hooks
+        );
+    }
+
+    template <typename Problem, typename State, typename Hooks = counting_hooks>
+    std::optional<State> best_first(Problem& problem, std::vector<State> initial,
+            const options& opts = {}, Hooks hooks = {}) {
+        return detail::run<frontier::min_priority>(
+            problem, std::move(initial),
+            [&problem](const State& s)->int64_t { return problem.priority(s); },
+            opts, hooks
+        );
+    }
+
+    template <typename Problem, typename State, typename Hooks = counting_hooks>
+    std::optional<State> astar(Problem& problem, std::vector<State> initial,
+            const options& opts = {}, Hooks hooks = {}) {
+        return detail::run<frontier::min_priority>(
+            problem, std::move(initial),
+            [&problem](const State& s)->int64_t { return problem.cost(s) + problem.heuristic(s); },
+            opts, hooks
+        );
+    }
+
+    template <typename Problem, typename State, typename Hooks = counting_hooks>
+    std::optional<State> bfs(Problem& problem, State initial, const options& opts = {}, Hooks hooks = {}) {
+        return bfs(problem, std::vector<State>{ std::move(initial) }, opts, hooks);
+    }
+
+    template <typename Problem, typename State, typename Hooks = counting_hooks>
+    std::optional<State> dfs(Problem& problem, State initial, const options& opts = {}, Hooks hooks = {}) {
+        return dfs(problem, std::vector<State>{ std::move(initial) }, opts, hooks);
+    }
+
+    template <typename Problem, typename State, typename Hooks = counting_hooks>
+    std::optional<State> best_first(Problem& problem, State initial, const options& opts = {}, Hooks hooks = {}) {
+        return best_first(problem, std::vector<State>{ std::move(initial) }, opts, hooks);
+    }
+
+    template <typename Problem, typename State, typename Hooks = counting_hooks>
+    std::optional<State> astar(Problem& problem, State initial, const options& opts = {}, Hooks hooks = {}) {
+        return astar(problem, std::vector<State>{ std::move(initial) }, opts, hooks);
+    }
+}
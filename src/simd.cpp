@@ -0,0 +1,806 @@
+#include "simd.h"
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define AOC_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(AOC_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define AOC_TARGET_SSE42 __attribute__((target("sse4.2,popcnt")))
+#define AOC_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#else
+#define AOC_TARGET_SSE42
+#define AOC_TARGET_AVX2
+#endif
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    // the letters' low six bits are distinct, 1 to 26 for A to Z and 33 to 58 for a to z, so the
+    // kernels gather a set of bits c & 63 and this moves it into letter_set's order
+    uint64_t letters_from_low_6_bits(uint64_t bits) {
+        constexpr uint64_t k_26_bits = (uint64_t{ 1 } << 26) - 1;
+        return ((bits >> 33) & k_26_bits) | (((bits >> 1) & k_26_bits) << 26);
+    }
+
+    struct kernel_table {
+        size_t (*count_byte)(const char*, size_t, char);
+        size_t (*find_byte)(const char*, size_t, char);
+        uint64_t (*match_mask_64)(const char*, char);
+        void (*classify_bytes)(const char*, size_t, uint8_t*,
+            const aoc::simd::nibble_table&, const aoc::simd::nibble_table&);
+        void (*lookup_nibbles)(const uint8_t*, size_t, uint8_t*, const aoc::simd::nibble_table&);
+        std::array<uint64_t, 2> (*sum_record_lookups)(const char*, size_t,
+            const aoc::simd::nibble_table&, const aoc::simd::nibble_table&);
+        uint64_t (*letter_set)(const char*, size_t);
+        std::array<uint64_t, 2> (*count_interval_pairs)(const int32_t*, const int32_t*,
+            const int32_t*, const int32_t*, size_t);
+        void (*inclusive_prefix_sum)(int32_t*, size_t);
+        uint64_t (*popcount)(const uint64_t*, size_t);
+        void (*shift_left)(uint64_t*, size_t, size_t);
+        void (*shift_right)(uint64_t*, size_t, size_t);
+    };
+
+    namespace scalar {
+
+        size_t count_byte(const char* data, size_t n, char ch) {
+            size_t count = 0;
+            for (size_t i = 0; i < n; ++i) {
+                count += (data[i] == ch) ? 1 : 0;
+            }
+            return count;
+        }
+
+        size_t find_byte(const char* data, size_t n, char ch) {
+            auto ptr = static_cast<const char*>(std::memchr(data, ch, n));
+            return ptr ? static_cast<size_t>(ptr - data) : n;
+        }
+
+        uint64_t match_mask_64(const char* data, char ch) {
+            uint64_t mask = 0;
+            for (int i = 0; i < 64; ++i) {
+                mask |= static_cast<uint64_t>(data[i] == ch) << i;
+            }
+            return mask;
+        }
+
+        void classify_bytes(const char* data, size_t n, uint8_t* out,
+                const aoc::simd::nibble_table& lo, const aoc::simd::nibble_table& hi) {
+            for (size_t i = 0; i < n; ++i) {
+                auto byte = static_cast<uint8_t>(data[i]);
+                out[i] = lo[byte & 0xF] & hi[byte >> 4];
+            }
+        }
+
+        void lookup_nibbles(const uint8_t* in, size_t n, uint8_t* out,
+                const aoc::simd::nibble_table& tbl) {
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = tbl[in[i] & 0xF];
+            }
+        }
+
+        std::array<uint64_t, 2> sum_record_lookups(const char* data, size_t records,
+                const aoc::simd::nibble_table& first, const aoc::simd::nibble_table& second) {
+            std::array<uint64_t, 2> sums = { 0, 0 };
+            for (size_t i = 0; i < records; ++i) {
+                auto rec = data + 4 * i;
+                auto key = ((rec[0] & 3) << 2) | (rec[2] & 3);
+                sums[0] += first[key];
+                sums[1] += second[key];
+            }
+            return sums;
+        }
+
+        uint64_t low_6_bit_set(const char* data, size_t n) {
+            uint64_t bits = 0;
+            for (size_t i = 0; i < n; ++i) {
+                auto is_letter = static_cast<uint8_t>((data[i] | 0x20) - 'a') < 26;
+                bits |= static_cast<uint64_t>(is_letter) << (data[i] & 63);
+            }
+            return bits;
+        }
+
+        uint64_t letter_set(const char* data, size_t n) {
+            return letters_from_low_6_bits(low_6_bit_set(data, n));
+        }
+
+        // the tests for one pair, as 0 or 1: (fully contained, overlapping)
+        std::array<uint32_t, 2> interval_pair_tests(int32_t af, int32_t at, int32_t bf,
+                int32_t bt) {
+            bool contained = (af <= bf && bt <= at) || (bf <= af && at <= bt);
+            bool overlapping = af <= bt && bf <= at;
+            return { contained ? 1u : 0u, overlapping ? 1u : 0u };
+        }
+
+        // blocks of a fixed eight pairs, whose tests compilers turn into vector compares even at
+        // -O2; a loop over a run-time count of pairs they leave as scalar code with branches
+        std::array<uint64_t, 2> count_interval_pairs(const int32_t* a_from, const int32_t* a_to,
+                const int32_t* b_from, const int32_t* b_to, size_t n) {
+            constexpr size_t k_block = 8;
+            uint64_t contained = 0;
+            uint64_t overlapping = 0;
+            size_t i = 0;
+            for (; i + k_block <= n; i += k_block) {
+                uint32_t block_contained = 0;
+                uint32_t block_overlapping = 0;
+                for (size_t j = i; j < i + k_block; ++j) {
+                    auto [c, o] = interval_pair_tests(a_from[j], a_to[j], b_from[j], b_to[j]);
+                    block_contained += c;
+                    block_overlapping += o;
+                }
+                contained += block_contained;
+                overlapping += block_overlapping;
+            }
+            for (; i < n; ++i) {
+                auto [c, o] = interval_pair_tests(a_from[i], a_to[i], b_from[i], b_to[i]);
+                contained += c;
+                overlapping += o;
+            }
+            return { contained, overlapping };
+        }
+
+        void inclusive_prefix_sum(int32_t* data, size_t n) {
+            int32_t sum = 0;
+            for (size_t i = 0; i < n; ++i) {
+                sum += data[i];
+                data[i] = sum;
+            }
+        }
+
+        uint64_t popcount(const uint64_t* words, size_t n) {
+            uint64_t count = 0;
+            for (size_t i = 0; i < n; ++i) {
+                count += std::popcount(words[i]);
+            }
+            return count;
+        }
+
+        void shift_left(uint64_t* words, size_t n, size_t bits) {
+            size_t word_shift = bits / 64;
+            size_t bit_shift = bits % 64;
+            for (size_t i = n; i-- > 0;) {
+                uint64_t val = 0;
+                if (i >= word_shift) {
+                    val = words[i - word_shift] << bit_shift;
+                    if (bit_shift && i >= word_shift + 1) {
+                        val |= words[i - word_shift - 1] >> (64 - bit_shift);
+                    }
+                }
+                words[i] = val;
+            }
+        }
+
+        void shift_right(uint64_t* words, size_t n, size_t bits) {
+            size_t word_shift = bits / 64;
+            size_t bit_shift = bits % 64;
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t val = 0;
+                if (i + word_shift < n) {
+                    val = words[i + word_shift] >> bit_shift;
+                    if (bit_shift && i + word_shift + 1 < n) {
+                        val |= words[i + word_shift + 1] << (64 - bit_shift);
+                    }
+                }
+                words[i] = val;
+            }
+        }
+
+        constexpr kernel_table kernels = {
+            count_byte, find_byte, match_mask_64, classify_bytes, lookup_nibbles,
+            sum_record_lookups, letter_set, count_interval_pairs, inclusive_prefix_sum, popcount,
+            shift_left, shift_right
+        };
+    }
+
+#ifdef AOC_SIMD_X86
+
+    namespace sse42 {
+
+        AOC_TARGET_SSE42 size_t count_byte(const char* data, size_t n, char ch) {
+            auto needle = _mm_set1_epi8(ch);
+            size_t count = 0;
+            size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                auto bits = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+                count += _mm_popcnt_u32(bits);
+            }
+            return count + scalar::count_byte(data + i, n - i, ch);
+        }
+
+        AOC_TARGET_SSE42 size_t find_byte(const char* data, size_t n, char ch) {
+            auto needle = _mm_set1_epi8(ch);
+            size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                auto bits = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+                if (bits) {
+                    return i + std::countr_zero(bits);
+                }
+            }
+            return i + scalar::find_byte(data + i, n - i, ch);
+        }
+
+        AOC_TARGET_SSE42 uint64_t match_mask_64(const char* data, char ch) {
+            auto needle = _mm_set1_epi8(ch);
+            uint64_t mask = 0;
+            for (int i = 0; i < 4; ++i) {
+                auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * i));
+                auto bits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+                mask |= static_cast<uint64_t>(bits) << (16 * i);
+            }
+            return mask;
+        }
+
+        AOC_TARGET_SSE42 void classify_bytes(const char* data, size_t n, uint8_t* out,
+                const aoc::simd::nibble_table& lo, const aoc::simd::nibble_table& hi) {
+            auto lo_tbl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lo.data()));
+            auto hi_tbl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hi.data()));
+            auto low_bits = _mm_set1_epi8(0x0F);
+            size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                auto lo_class = _mm_shuffle_epi8(lo_tbl, _mm_and_si128(block, low_bits));
+                auto hi_class = _mm_shuffle_epi8(hi_tbl,
+                    _mm_and_si128(_mm_srli_epi16(block, 4), low_bits));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_and_si128(lo_class, hi_class));
+            }
+            scalar::classify_bytes(data + i, n - i, out + i, lo, hi);
+        }
+
+        AOC_TARGET_SSE42 void lookup_nibbles(const uint8_t* in, size_t n, uint8_t* out,
+                const aoc::simd::nibble_table& tbl) {
+            auto table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tbl.data()));
+            auto low_bits = _mm_set1_epi8(0x0F);
+            size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+                auto result = _mm_shuffle_epi8(table, _mm_and_si128(block, low_bits));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), result);
+            }
+            scalar::lookup_nibbles(in + i, n - i, out + i, tbl);
+        }
+
+        // the key is built in the low byte of each 32-bit lane, the lookups are masked back to
+        // that byte and summed with psadbw
+        AOC_TARGET_SSE42 std::array<uint64_t, 2> sum_record_lookups(const char* data,
+                size_t records, const aoc::simd::nibble_table& first,
+                const aoc::simd::nibble_table& second) {
+            auto first_tbl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first.data()));
+            auto second_tbl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(second.data()));
+            auto low_2_bits = _mm_set1_epi32(3);
+            auto low_byte = _mm_set1_epi32(0xFF);
+            auto first_sum = _mm_setzero_si128();
+            auto second_sum = _mm_setzero_si128();
+            size_t i = 0;
+            for (; i + 4 <= records; i += 4) {
+                auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 4 * i));
+                auto key = _mm_or_si128(
+                    _mm_slli_epi32(_mm_and_si128(block, low_2_bits), 2),
+                    _mm_and_si128(_mm_srli_epi32(block, 16), low_2_bits)
+                );
+                auto first_vals = _mm_and_si128(_mm_shuffle_epi8(first_tbl, key), low_byte);
+                auto second_vals = _mm_and_si128(_mm_shuffle_epi8(second_tbl, key), low_byte);
+                first_sum = _mm_add_epi64(first_sum, _mm_sad_epu8(first_vals, _mm_setzero_si128()));
+                second_sum = _mm_add_epi64(second_sum, _mm_sad_epu8(second_vals, _mm_setzero_si128()));
+            }
+            alignas(16) uint64_t first_lanes[2];
+            alignas(16) uint64_t second_lanes[2];
+            _mm_store_si128(reinterpret_cast<__m128i*>(first_lanes), first_sum);
+            _mm_store_si128(reinterpret_cast<__m128i*>(second_lanes), second_sum);
+            auto sums = scalar::sum_record_lookups(data + 4 * i, records - i, first, second);
+            sums[0] += first_lanes[0] + first_lanes[1];
+            sums[1] += second_lanes[0] + second_lanes[1];
+            return sums;
+        }
+
+        // the bytes of x or-ed together
+        AOC_TARGET_SSE42 uint64_t or_bytes(__m128i x) {
+            x = _mm_or_si128(x, _mm_srli_si128(x, 8));
+            x = _mm_or_si128(x, _mm_srli_si128(x, 4));
+            x = _mm_or_si128(x, _mm_srli_si128(x, 2));
+            x = _mm_or_si128(x, _mm_srli_si128(x, 1));
+            return static_cast<uint8_t>(_mm_cvtsi128_si32(x));
+        }
+
+        // each letter sets bit c & 7 of byte (c & 63) >> 3 of the set. the bit comes from a
+        // shuffle and is or-ed into the one of eight accumulators whose index matches the byte;
+        // non-letters have their bit cleared first.
+        AOC_TARGET_SSE42 uint64_t letter_set(const char* data, size_t n) {
+            auto bit_tbl = _mm_setr_epi8(
+                1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128
+            );
+            auto low_3_bits = _mm_set1_epi8(7);
+            auto lower_case = _mm_set1_epi8(0x20);
+            auto a = _mm_set1_epi8('a');
+            auto last_letter = _mm_set1_epi8(25);
+            __m128i acc[8];
+            for (auto& lane : acc) {
+                lane = _mm_setzero_si128();
+            }
+            size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                auto letter = _mm_sub_epi8(_mm_or_si128(block, lower_case), a);
+                auto is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, last_letter), letter);
+                auto bit = _mm_and_si128(
+                    _mm_shuffle_epi8(bit_tbl, _mm_and_si128(block, low_3_bits)), is_letter);
+                auto byte = _mm_and_si128(_mm_srli_epi16(block, 3), low_3_bits);
+                for (int j = 0; j < 8; ++j) {
+                    acc[j] = _mm_or_si128(acc[j],
+                        _mm_and_si128(_mm_cmpeq_epi8(byte, _mm_set1_epi8(j)), bit));
+                }
+            }
+            uint64_t bits = scalar::low_6_bit_set(data + i, n - i);
+            for (int j = 0; j < 8; ++j) {
+                bits |= or_bytes(acc[j]) << (8 * j);
+            }
+            return letters_from_low_6_bits(bits);
+        }
+
+        // x <= y is the complement of x > y, so each test is the or of two signed compares
+        // negated; the lanes' results are counted from their sign bits
+        AOC_TARGET_SSE42 std::array<uint64_t, 2> count_interval_pairs(const int32_t* a_from,
+                const int32_t* a_to, const int32_t* b_from, const int32_t* b_to, size_t n) {
+            std::array<uint64_t, 2> counts = { 0, 0 };
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4) {
+                auto af = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a_from + i));
+                auto at = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a_to + i));
+                auto bf = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b_from + i));
+                auto bt = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b_to + i));
+                auto a_misses_b = _mm_or_si128(_mm_cmpgt_epi32(af, bf), _mm_cmpgt_epi32(bt, at));
+                auto b_misses_a = _mm_or_si128(_mm_cmpgt_epi32(bf, af), _mm_cmpgt_epi32(at, bt));
+                auto apart = _mm_or_si128(_mm_cmpgt_epi32(af, bt), _mm_cmpgt_epi32(bf, at));
+                // a pair counts unless neither interval contains the other, or they are apart
+                auto not_contained = _mm_and_si128(a_misses_b, b_misses_a);
+                counts[0] += 4 - _mm_popcnt_u32(_mm_movemask_ps(_mm_castsi128_ps(not_contained)));
+                counts[1] += 4 - _mm_popcnt_u32(_mm_movemask_ps(_mm_castsi128_ps(apart)));
+            }
+            auto tail = scalar::count_interval_pairs(
+                a_from + i, a_to + i, b_from + i, b_to + i, n - i);
+            return { counts[0] + tail[0], counts[1] + tail[1] };
+        }
+
+        AOC_TARGET_SSE42 void inclusive_prefix_sum(int32_t* data, size_t n) {
+            auto carry = _mm_setzero_si128();
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4) {
+                auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+                x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+                x = _mm_add_epi32(x, carry);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), x);
+                carry = _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3));
+            }
+            int32_t sum = _mm_cvtsi128_si32(carry);
+            for (; i < n; ++i) {
+                sum += data[i];
+                data[i] = sum;
+            }
+        }
+
+        AOC_TARGET_SSE42 uint64_t popcount(const uint64_t* words, size_t n) {
+            uint64_t count = 0;
+            for (size_t i = 0; i < n; ++i) {
+#if defined(__x86_64__) || defined(_M_X64)
+                count += _mm_popcnt_u64(words[i]);
+#else
+                count += _mm_popcnt_u32(static_cast<uint32_t>(words[i])) +
+                    _mm_popcnt_u32(static_cast<uint32_t>(words[i] >> 32));
+#endif
+            }
+            return count;
+        }
+
+        constexpr kernel_table kernels = {
+            count_byte, find_byte, match_mask_64, classify_bytes, lookup_nibbles,
+            sum_record_lookups, letter_set, count_interval_pairs, inclusive_prefix_sum, popcount,
+            scalar::shift_left, scalar::shift_right
+        };
+    }
+
+    namespace avx2 {
+
+        AOC_TARGET_AVX2 size_t count_byte(const char* data, size_t n, char ch) {
+            auto needle = _mm256_set1_epi8(ch);
+            size_t count = 0;
+            size_t i = 0;
+            for (; i + 32 <= n; i += 32) {
+                auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                auto bits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle)));
+                count += _mm_popcnt_u32(bits);
+            }
+            return count + sse42::count_byte(data + i, n - i, ch);
+        }
+
+        AOC_TARGET_AVX2 size_t find_byte(const char* data, size_t n, char ch) {
+            auto needle = _mm256_set1_epi8(ch);
+            size_t i = 0;
+            for (; i + 32 <= n; i += 32) {
+                auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                auto bits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle)));
+                if (bits) {
+                    return i + std::countr_zero(bits);
+                }
+            }
+            return i + sse42::find_byte(data + i, n - i, ch);
+        }
+
+        AOC_TARGET_AVX2 uint64_t match_mask_64(const char* data, char ch) {
+            auto needle = _mm256_set1_epi8(ch);
+            auto lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+            auto hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32));
+            auto lo_bits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, needle)));
+            auto hi_bits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, needle)));
+            return static_cast<uint64_t>(lo_bits) | (static_cast<uint64_t>(hi_bits) << 32);
+        }
+
+        AOC_TARGET_AVX2 void classify_bytes(const char* data, size_t n, uint8_t* out,
+                const aoc::simd::nibble_table& lo, const aoc::simd::nibble_table& hi) {
+            auto lo_tbl = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(lo.data())));
+            auto hi_tbl = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(hi.data())));
+            auto low_bits = _mm256_set1_epi8(0x0F);
+            size_t i = 0;
+            for (; i + 32 <= n; i += 32) {
+                auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                auto lo_class = _mm256_shuffle_epi8(lo_tbl, _mm256_and_si256(block, low_bits));
+                auto hi_class = _mm256_shuffle_epi8(hi_tbl,
+                    _mm256_and_si256(_mm256_srli_epi16(block, 4), low_bits));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                    _mm256_and_si256(lo_class, hi_class));
+            }
+            sse42::classify_bytes(data + i, n - i, out + i, lo, hi);
+        }
+
+        AOC_TARGET_AVX2 void lookup_nibbles(const uint8_t* in, size_t n, uint8_t* out,
+                const aoc::simd::nibble_table& tbl) {
+            auto table = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(tbl.data())));
+            auto low_bits = _mm256_set1_epi8(0x0F);
+            size_t i = 0;
+            for (; i + 32 <= n; i += 32) {
+                auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+                auto result = _mm256_shuffle_epi8(table, _mm256_and_si256(block, low_bits));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), result);
+            }
+            sse42::lookup_nibbles(in + i, n - i, out + i, tbl);
+        }
+
+        AOC_TARGET_AVX2 std::array<uint64_t, 2> sum_record_lookups(const char* data,
+                size_t records, const aoc::simd::nibble_table& first,
+                const aoc::simd::nibble_table& second) {
+            auto first_tbl = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(first.data())));
+            auto second_tbl = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(second.data())));
+            auto low_2_bits = _mm256_set1_epi32(3);
+            auto low_byte = _mm256_set1_epi32(0xFF);
+            auto first_sum = _mm256_setzero_si256();
+            auto second_sum = _mm256_setzero_si256();
+            size_t i = 0;
+            for (; i + 8 <= records; i += 8) {
+                auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 4 * i));
+                auto key = _mm256_or_si256(
+                    _mm256_slli_epi32(_mm256_and_si256(block, low_2_bits), 2),
+                    _mm256_and_si256(_mm256_srli_epi32(block, 16), low_2_bits)
+                );
+                auto first_vals = _mm256_and_si256(_mm256_shuffle_epi8(first_tbl, key), low_byte);
+                auto second_vals = _mm256_and_si256(_mm256_shuffle_epi8(second_tbl, key), low_byte);
+                first_sum = _mm256_add_epi64(first_sum,
+                    _mm256_sad_epu8(first_vals, _mm256_setzero_si256()));
+                second_sum = _mm256_add_epi64(second_sum,
+                    _mm256_sad_epu8(second_vals, _mm256_setzero_si256()));
+            }
+            alignas(32) uint64_t first_lanes[4];
+            alignas(32) uint64_t second_lanes[4];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(first_lanes), first_sum);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(second_lanes), second_sum);
+            auto sums = sse42::sum_record_lookups(data + 4 * i, records - i, first, second);
+            sums[0] += first_lanes[0] + first_lanes[1] + first_lanes[2] + first_lanes[3];
+            sums[1] += second_lanes[0] + second_lanes[1] + second_lanes[2] + second_lanes[3];
+            return sums;
+        }
+
+        AOC_TARGET_AVX2 uint64_t letter_set(const char* data, size_t n) {
+            auto bit_tbl = _mm256_setr_epi8(
+                1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+                1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128
+            );
+            auto low_3_bits = _mm256_set1_epi8(7);
+            auto lower_case = _mm256_set1_epi8(0x20);
+            auto a = _mm256_set1_epi8('a');
+            auto last_letter = _mm256_set1_epi8(25);
+            __m256i acc[8];
+            for (auto& lane : acc) {
+                lane = _mm256_setzero_si256();
+            }
+            size_t i = 0;
+            for (; i + 32 <= n; i += 32) {
+                auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                auto letter = _mm256_sub_epi8(_mm256_or_si256(block, lower_case), a);
+                auto is_letter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, last_letter), letter);
+                auto bit = _mm256_and_si256(
+                    _mm256_shuffle_epi8(bit_tbl, _mm256_and_si256(block, low_3_bits)), is_letter);
+                auto byte = _mm256_and_si256(_mm256_srli_epi16(block, 3), low_3_bits);
+                for (int j = 0; j < 8; ++j) {
+                    acc[j] = _mm256_or_si256(acc[j],
+                        _mm256_and_si256(_mm256_cmpeq_epi8(byte, _mm256_set1_epi8(j)), bit));
+                }
+            }
+            uint64_t bits = 0;
+            for (int j = 0; j < 8; ++j) {
+                auto halves = _mm_or_si128(
+                    _mm256_castsi256_si128(acc[j]), _mm256_extracti128_si256(acc[j], 1));
+                bits |= sse42::or_bytes(halves) << (8 * j);
+            }
+            return letters_from_low_6_bits(bits) | sse42::letter_set(data + i, n - i);
+        }
+
+        AOC_TARGET_AVX2 std::array<uint64_t, 2> count_interval_pairs(const int32_t* a_from,
+                const int32_t* a_to, const int32_t* b_from, const int32_t* b_to, size_t n) {
+            std::array<uint64_t, 2> counts = { 0, 0 };
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                auto af = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a_from + i));
+                auto at = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a_to + i));
+                auto bf = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b_from + i));
+                auto bt = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b_to + i));
+                auto a_misses_b = _mm256_or_si256(
+                    _mm256_cmpgt_epi32(af, bf), _mm256_cmpgt_epi32(bt, at));
+                auto b_misses_a = _mm256_or_si256(
+                    _mm256_cmpgt_epi32(bf, af), _mm256_cmpgt_epi32(at, bt));
+                auto apart = _mm256_or_si256(
+                    _mm256_cmpgt_epi32(af, bt), _mm256_cmpgt_epi32(bf, at));
+                auto not_contained = _mm256_and_si256(a_misses_b, b_misses_a);
+                counts[0] += 8 - _mm_popcnt_u32(
+                    _mm256_movemask_ps(_mm256_castsi256_ps(not_contained)));
+                counts[1] += 8 - _mm_popcnt_u32(_mm256_movemask_ps(_mm256_castsi256_ps(apart)));
+            }
+            auto tail = sse42::count_interval_pairs(
+                a_from + i, a_to + i, b_from + i, b_to + i, n - i);
+            return { counts[0] + tail[0], counts[1] + tail[1] };
+        }
+
+        AOC_TARGET_AVX2 void inclusive_prefix_sum(int32_t* data, size_t n) {
+            auto carry = _mm256_setzero_si256();
+            auto last_lane = _mm256_set1_epi32(7);
+            auto lane_3 = _mm256_set1_epi32(3);
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                // scan within each 128-bit lane, then add the low lane's total to the high lane
+                x = _mm256_add_epi32(x, _mm256_slli_si256(x, 4));
+                x = _mm256_add_epi32(x, _mm256_slli_si256(x, 8));
+                auto low_total = _mm256_permutevar8x32_epi32(x, lane_3);
+                x = _mm256_add_epi32(x, _mm256_blend_epi32(_mm256_setzero_si256(), low_total, 0xF0));
+                x = _mm256_add_epi32(x, carry);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i), x);
+                carry = _mm256_permutevar8x32_epi32(x, last_lane);
+            }
+            int32_t sum = _mm256_cvtsi256_si32(carry);
+            for (; i < n; ++i) {
+                sum += data[i];
+                data[i] = sum;
+            }
+        }
+
+        // nibble-lookup popcount (Mula et al.) accumulated with vpsadbw
+        AOC_TARGET_AVX2 uint64_t popcount(const uint64_t* words, size_t n) {
+            auto lookup = _mm256_setr_epi8(
+                0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+            );
+            auto low_bits = _mm256_set1_epi8(0x0F);
+            auto total = _mm256_setzero_si256();
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4) {
+                auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+                auto lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(block, low_bits));
+                auto hi = _mm256_shuffle_epi8(lookup,
+                    _mm256_and_si256(_mm256_srli_epi16(block, 4), low_bits));
+                total = _mm256_add_epi64(total,
+                    _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+            }
+            alignas(32) uint64_t lanes[4];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), total);
+            return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sse42::popcount(words + i, n - i);
+        }
+
+        AOC_TARGET_AVX2 void shift_left(uint64_t* words, size_t n, size_t bits) {
+            size_t word_shift = bits / 64;
+            if (word_shift >= n) {
+                std::memset(words, 0, n * sizeof(uint64_t));
+                return;
+            }
+            auto left = _mm_cvtsi32_si128(static_cast<int>(bits % 64));
+            auto right = _mm_cvtsi32_si128(static_cast<int>(64 - bits % 64));
+            // walk downward from the top so that every source word is read before it is
+            // overwritten; out[i] needs in[i - ws] and in[i - ws - 1].
+            size_t i = n;
+            while (i >= word_shift + 5) {
+                i -= 4;
+                auto hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i - word_shift));
+                auto lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i - word_shift - 1));
+                auto val = _mm256_or_si256(_mm256_sll_epi64(hi, left), _mm256_srl_epi64(lo, right));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(words + i), val);
+            }
+            scalar::shift_left(words, i, bits);
+        }
+
+        AOC_TARGET_AVX2 void shift_right(uint64_t* words, size_t n, size_t bits) {
+            size_t word_shift = bits / 64;
+            if (word_shift >= n) {
+                std::memset(words, 0, n * sizeof(uint64_t));
+                return;
+            }
+            auto right = _mm_cvtsi32_si128(static_cast<int>(bits % 64));
+            auto left = _mm_cvtsi32_si128(static_cast<int>(64 - bits % 64));
+            // walk upward; out[i] needs in[i + ws] and in[i + ws + 1].
+            size_t i = 0;
+            for (; i + word_shift + 5 <= n; i += 4) {
+                auto lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i + word_shift));
+                auto hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i + word_shift + 1));
+                auto val = _mm256_or_si256(_mm256_srl_epi64(lo, right), _mm256_sll_epi64(hi, left));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(words + i), val);
+            }
+            for (; i < n; ++i) {
+                uint64_t val = 0;
+                if (i + word_shift < n) {
+                    val = words[i + word_shift] >> (bits % 64);
+                    if (bits % 64 && i + word_shift + 1 < n) {
+                        val |= words[i + word_shift + 1] << (64 - bits % 64);
+                    }
+                }
+                words[i] = val;
+            }
+        }
+
+        constexpr kernel_table kernels = {
+            count_byte, find_byte, match_mask_64, classify_bytes, lookup_nibbles,
+            sum_record_lookups, letter_set, count_interval_pairs, inclusive_prefix_sum, popcount,
+            shift_left, shift_right
+        };
+    }
+
+    aoc::simd::isa detect_isa() {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int regs[4];
+        __cpuid(regs, 0);
+        int max_leaf = regs[0];
+        __cpuid(regs, 1);
+        bool sse42 = (regs[2] & (1 << 20)) && (regs[2] & (1 << 23));
+        bool os_saves_ymm = (regs[2] & (1 << 27)) && ((_xgetbv(0) & 0x6) == 0x6);
+        // avx2 is reported in leaf 7, which older cpus that still have sse4.2 lack
+        bool avx2 = false;
+        if (sse42 && os_saves_ymm && max_leaf >= 7) {
+            __cpuidex(regs, 7, 0);
+            avx2 = (regs[1] & (1 << 5)) != 0;
+        }
+#else
+        __builtin_cpu_init();
+        bool sse42 = __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt");
+        bool avx2 = sse42 && __builtin_cpu_supports("avx2");
+#endif
+        if (avx2) {
+            return aoc::simd::isa::avx2;
+        }
+        return sse42 ? aoc::simd::isa::sse42 : aoc::simd::isa::scalar;
+    }
+
+#else
+
+    aoc::simd::isa detect_isa() {
+        return aoc::simd::isa::scalar;
+    }
+
+#endif
+
+    aoc::simd::isa select_isa() {
+        auto level = detect_isa();
+        const char* cap = std::getenv("AOC_SIMD");
+        if (cap) {
+            std::string requested = cap;
+            if (requested == "scalar") {
+                level = aoc::simd::isa::scalar;
+            } else if (requested == "sse4.2" && level > aoc::simd::isa::sse42) {
+                level = aoc::simd::isa::sse42;
+            }
+        }
+        return level;
+    }
+
+    const kernel_table& kernels() {
+        static const kernel_table& tbl = []()->const kernel_table& {
+            switch (aoc::simd::active_isa()) {
+#ifdef AOC_SIMD_X86
+                case aoc::simd::isa::avx2:
+                    return avx2::kernels;
+                case aoc::simd::isa::sse42:
+                    return sse42::kernels;
+#endif
+                default:
+                    return scalar::kernels;
+            }
+        }();
+        return tbl;
+    }
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+aoc::simd::isa aoc::simd::active_isa() {
+    static const auto level = select_isa();
+    return level;
+}
+
+std::string aoc::simd::isa_name(isa level) {
+    switch (level) {
+        case isa::avx2:
+            return "avx2";
+        case isa::sse42:
+            return "sse4.2";
+        default:
+            return "scalar";
+    }
+}
+
+size_t aoc::simd::count_byte(const char* data, size_t n, char ch) {
+    return kernels().count_byte(data, n, ch);
+}
+
+size_t aoc::simd::find_byte(const char* data, size_t n, char ch) {
+    return kernels().find_byte(data, n, ch);
+}
+
+uint64_t aoc::simd::match_mask_64(const char* data, char ch) {
+    return kernels().match_mask_64(data, ch);
+}
+
+void aoc::simd::classify_bytes(const char* data, size_t n, uint8_t* out,
+        const nibble_table& low_nibble, const nibble_table& high_nibble) {
+    kernels().classify_bytes(data, n, out, low_nibble, high_nibble);
+}
+
+void aoc::simd::lookup_nibbles(const uint8_t* in, size_t n, uint8_t* out, const nibble_table& table) {
+    kernels().lookup_nibbles(in, n, out, table);
+}
+
+std::array<uint64_t, 2> aoc::simd::sum_record_lookups(const char* data, size_t records,
+        const nibble_table& first, const nibble_table& second) {
+    return kernels().sum_record_lookups(data, records, first, second);
+}
+
+uint64_t aoc::simd::letter_set(const char* data, size_t n) {
+    return kernels().letter_set(data, n);
+}
+
+std::array<uint64_t, 2> aoc::simd::count_interval_pairs(const int32_t* a_from,
+        const int32_t* a_to, const int32_t* b_from, const int32_t* b_to, size_t n) {
+    return kernels().count_interval_pairs(a_from, a_to, b_from, b_to, n);
+}
+
+void aoc::simd::inclusive_prefix_sum(int32_t* data, size_t n) {
+    kernels().inclusive_prefix_sum(data, n);
+}
+
+uint64_t aoc::simd::popcount(const uint64_t* words, size_t n) {
+    return kernels().popcount(words, n);
+}
+
+void aoc::simd::shift_left(uint64_t* words, size_t n, size_t bits) {
+    kernels().shift_left(words, n, bits);
+}
+
+void aoc::simd::shift_right(uint64_t* words, size_t n, size_t bits) {
+    kernels().shift_right(words, n, bits);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <string>
+
+/*------------------------------------------------------------------------------------------------*/
+
+// byte and bit kernels with scalar, SSE4.2 and AVX2 implementations. the widest variant the
+// CPU supports is selected once, at first use; setting the environment variable AOC_SIMD to
+// "scalar" or "sse4.2" caps the selection, which is handy for comparing the variants.
+
+namespace aoc::simd {
+
+    enum class isa {
+        scalar = 0,
+        sse42,
+        avx2
+    };
+
+    isa active_isa();
+    std::string isa_name(isa level);
+
+    using nibble_table = std::array<uint8_t, 16>;
+
+    // byte compare / classify
+    size_t count_byte(const char* data, size_t n, char ch);
+    size_t find_byte(const char* data, size_t n, char ch); // n if not found
+    uint64_t match_mask_64(const char* data, char ch);      // bit i set if data[i] == ch
+    void classify_bytes(const char* data, size_t n, uint8_t* out,
+        const nibble_table& low_nibble, const nibble_table& high_nibble);
+
+    // pshufb-style lookup: out[i] = table[in[i] & 0xF]
+    void lookup_nibbles(const uint8_t* in, size_t n, uint8_t* out, const nibble_table& table);
+
+    // four-byte records such as "A X\n": each record's key is the nibble
+    // ((rec[0] & 3) << 2) | (rec[2] & 3), and the result is the sums of first[key] and of
+    // second[key] over all the records, taken in one pass
+    std::array<uint64_t, 2> sum_record_lookups(const char* data, size_t records,
+        const nibble_table& first, const nibble_table& second);
+
+    // the ASCII letters of data as a set of bits, a to z at 0 to 25 and A to Z at 26 to 51;
+    // other bytes are ignored
+    uint64_t letter_set(const char* data, size_t n);
+
+    // closed intervals a and b given as four columns: the number of pairs in which one interval
+    // contains the other, and the number in which they overlap
+    std::array<uint64_t, 2> count_interval_pairs(const int32_t* a_from, const int32_t* a_to,
+        const int32_t* b_from, const int32_t* b_to, size_t n);
+
+    // prefix scans
+    void inclusive_prefix_sum(int32_t* data, size_t n);
+
+    inline uint64_t prefix_xor(uint64_t bits) {
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
+    }
+
+    // population count
+    uint64_t popcount(const uint64_t* words, size_t n);
+
+    // shifts of a little-endian multi-word bitset (bit 0 is bit 0 of words[0]); done in place,
+    // bits shifted past either end are dropped and vacated bits are zero.
+    void shift_left(uint64_t* words, size_t n, size_t bits);
+    void shift_right(uint64_t* words, size_t n, size_t bits);
+}
@@ -0,0 +1,488 @@
+#include "simd_check.h"
+#include "simd.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    // the correctness inputs run from empty to a few vector widths past the 64-byte blocks, at
+    // every offset within a word, so that every head, body and tail path is taken
+    constexpr size_t k_max_check_size = 300;
+    constexpr size_t k_max_offset = 8;
+
+    constexpr size_t k_bench_bytes = 1 << 20;
+    constexpr auto k_min_bench_time = std::chrono::milliseconds(20);
+    constexpr int k_bench_runs = 3;
+
+    // keeps the benchmarked results alive
+    volatile uint64_t sink = 0;
+
+    std::mt19937_64& rng() {
+        static std::mt19937_64 gen(2022);
+        return gen;
+    }
+
+    // mostly letters, with line breaks and spaces, and now and then any byte at all
+    std::vector<char> random_text(size_t n) {
+        static const std::string common = "abcxyzABCXYZ 0123456789\n\n";
+        std::vector<char> text(n);
+        for (auto& ch : text) {
+            auto r = rng()();
+            ch = (r % 8 == 0) ? static_cast<char>(r >> 8) : common[(r >> 8) % common.size()];
+        }
+        return text;
+    }
+
+    aoc::simd::nibble_table random_table() {
+        aoc::simd::nibble_table tbl;
+        for (auto& entry : tbl) {
+            entry = static_cast<uint8_t>(rng()());
+        }
+        return tbl;
+    }
+
+    // gigabytes per second of fn, which processes bytes, as the best of a few runs of long
+    // enough to time
+    template <typename F>
+    double throughput(size_t bytes, F fn) {
+        using clock = std::chrono::steady_clock;
+        double best = 0.0;
+        for (int run = 0; run < k_bench_runs; ++run) {
+            size_t reps = 0;
+            auto start = clock::now();
+            auto elapsed = clock::duration::zero();
+            do {
+                fn();
+                ++reps;
+                elapsed = clock::now() - start;
+            } while (elapsed < k_min_bench_time);
+            auto ns = std::chrono::duration<double, std::nano>(elapsed).count();
+            best = std::max(best, static_cast<double>(bytes * reps) / ns);
+        }
+        return best;
+    }
+
+    class checker {
+        std::ostream& os_;
+        int failures_ = 0;
+
+    public:
+        explicit checker(std::ostream& os) : os_(os) {
+            os_ << "  simd kernels, " << aoc::simd::isa_name(aoc::simd::active_isa()) <<
+                " against the scalar reference (GB/s):\n";
+        }
+
+        // ok is whether the kernel matched the reference; kernel and reference are timed on
+        // inputs of the given size
+        template <typename K, typename R>
+        void report(const std::string& name, bool ok, size_t bytes, K kernel, R reference) {
+            auto kernel_rate = throughput(bytes, kernel);
+            auto reference_rate = throughput(bytes, reference);
+            os_ << "    " << std::left << std::setw(22) << name << std::right << std::fixed <<
+                std::setprecision(2) << std::setw(8) << kernel_rate << std::setw(8) <<
+                reference_rate << std::setw(7) << kernel_rate / reference_rate << "x  " <<
+                (ok ? "ok" : "MISMATCH") << "\n";
+            failures_ += ok ? 0 : 1;
+        }
+
+        int failures() const {
+            return failures_;
+        }
+    };
+
+    // calls check(data, n) on random text of every check size and offset, and is true if every
+    // call is
+    template <typename F>
+    bool all_sizes(F check) {
+        bool ok = true;
+        for (size_t n = 0; n <= k_max_check_size; ++n) {
+            auto text = random_text(n + k_max_offset);
+            for (size_t offset = 0; offset < k_max_offset; ++offset) {
+                ok = ok && check(text.data() + offset, n);
+            }
+        }
+        return ok;
+    }
+
+    void check_count_and_find(checker& c) {
+        auto ref_count = [](const char* data, size_t n, char ch) {
+            return static_cast<size_t>(std::count(data, data + n, ch));
+        };
+        auto ref_find = [](const char* data, size_t n, char ch) {
+            return static_cast<size_t>(std::find(data, data + n, ch) - data);
+        };
+        bool count_ok = all_sizes(
+            [&](const char* data, size_t n) {
+                return aoc::simd::count_byte(data, n, '\n') == ref_count(data, n, '\n');
+            }
+        );
+        bool find_ok = all_sizes(
+            [&](const char* data, size_t n) {
+                return aoc::simd::find_byte(data, n, '\n') == ref_find(data, n, '\n') &&
+                    aoc::simd::find_byte(data, n, '#') == ref_find(data, n, '#');
+            }
+        );
+
+        auto text = random_text(k_bench_bytes);
+        std::replace(text.begin(), text.end(), '#', ' ');
+        c.report("count_byte", count_ok, text.size(),
+            [&] { sink = aoc::simd::count_byte(text.data(), text.size(), '\n'); },
+            [&] { sink = ref_count(text.data(), text.size(), '\n'); }
+        );
+        // a needle that is not there, so that the whole input is scanned
+        c.report("find_byte", find_ok, text.size(),
+            [&] { sink = aoc::simd::find_byte(text.data(), text.size(), '#'); },
+            [&] { sink = ref_find(text.data(), text.size(), '#'); }
+        );
+    }
+
+    void check_match_mask(checker& c) {
+        auto ref_mask = [](const char* data, char ch) {
+            uint64_t mask = 0;
+            for (int i = 0; i < 64; ++i) {
+                mask |= static_cast<uint64_t>(data[i] == ch) << i;
+            }
+            return mask;
+        };
+        bool ok = true;
+        for (int i = 0; i < 1000; ++i) {
+            auto text = random_text(64 + k_max_offset);
+            auto data = text.data() + i % k_max_offset;
+            ok = ok && aoc::simd::match_mask_64(data, '\n') == ref_mask(data, '\n');
+        }
+
+        auto text = random_text(k_bench_bytes);
+        auto masks = [&](auto fn) {
+            return [&, fn] {
+                uint64_t acc = 0;
+                for (size_t i = 0; i + 64 <= text.size(); i += 64) {
+                    acc ^= fn(text.data() + i, '\n');
+                }
+                sink = acc;
+            };
+        };
+        c.report("match_mask_64", ok, text.size(),
+            masks([](const char* data, char ch) { return aoc::simd::match_mask_64(data, ch); }),
+            masks(ref_mask)
+        );
+    }
+
+    void check_nibble_lookups(checker& c) {
+        auto lo = random_table();
+        auto hi = random_table();
+        auto ref_classify = [&](const char* data, size_t n, uint8_t* out) {
+            for (size_t i = 0; i < n; ++i) {
+                auto byte = static_cast<uint8_t>(data[i]);
+                out[i] = lo[byte & 0xF] & hi[byte >> 4];
+            }
+        };
+        auto ref_lookup = [&](const uint8_t* in, size_t n, uint8_t* out) {
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = lo[in[i] & 0xF];
+            }
+        };
+        std::vector<uint8_t> out(k_max_check_size);
+        std::vector<uint8_t> expected(k_max_check_size);
+        bool classify_ok = all_sizes(
+            [&](const char* data, size_t n) {
+                aoc::simd::classify_bytes(data, n, out.data(), lo, hi);
+                ref_classify(data, n, expected.data());
+                return std::equal(out.begin(), out.begin() + n, expected.begin());
+            }
+        );
+        bool lookup_ok = all_sizes(
+            [&](const char* data, size_t n) {
+                auto in = reinterpret_cast<const uint8_t*>(data);
+                aoc::simd::lookup_nibbles(in, n, out.data(), lo);
+                ref_lookup(in, n, expected.data());
+                return std::equal(out.begin(), out.begin() + n, expected.begin());
+            }
+        );
+
+        auto text = random_text(k_bench_bytes);
+        auto bytes = reinterpret_cast<const uint8_t*>(text.data());
+        std::vector<uint8_t> bench_out(text.size());
+        c.report("classify_bytes", classify_ok, text.size(),
+            [&] { aoc::simd::classify_bytes(text.data(), text.size(), bench_out.data(), lo, hi); },
+            [&] { ref_classify(text.data(), text.size(), bench_out.data()); }
+        );
+        c.report("lookup_nibbles", lookup_ok, text.size(),
+            [&] { aoc::simd::lookup_nibbles(bytes, text.size(), bench_out.data(), lo); },
+            [&] { ref_lookup(bytes, text.size(), bench_out.data()); }
+        );
+    }
+
+    void check_record_lookups(checker& c) {
+        auto first = random_table();
+        auto second = random_table();
+        auto reference = [&](const char* data, size_t records) {
+            std::array<uint64_t, 2> sums = { 0, 0 };
+            for (size_t i = 0; i < records; ++i) {
+                auto key = ((data[4 * i] & 3) << 2) | (data[4 * i + 2] & 3);
+                sums[0] += first[key];
+                sums[1] += second[key];
+            }
+            return sums;
+        };
+        bool ok = all_sizes(
+            [&](const char* data, size_t n) {
+                auto records = n / 4;
+                return aoc::simd::sum_record_lookups(data, records, first, second) ==
+                    reference(data, records);
+            }
+        );
+
+        auto text = random_text(k_bench_bytes);
+        c.report("sum_record_lookups", ok, text.size(),
+            [&] {
+                auto records = text.size() / 4;
+                sink = aoc::simd::sum_record_lookups(text.data(), records, first, second)[0];
+            },
+            [&] { sink = reference(text.data(), text.size() / 4)[0]; }
+        );
+    }
+
+    void check_letter_set(checker& c) {
+        auto reference = [](const char* data, size_t n) {
+            uint64_t set = 0;
+            for (size_t i = 0; i < n; ++i) {
+                if (data[i] >= 'a' && data[i] <= 'z') {
+                    set |= uint64_t{ 1 } << (data[i] - 'a');
+                } else if (data[i] >= 'A' && data[i] <= 'Z') {
+                    set |= uint64_t{ 1 } << (data[i] - 'A' + 26);
+                }
+            }
+            return set;
+        };
+        bool ok = all_sizes(
+            [&](const char* data, size_t n) {
+                return aoc::simd::letter_set(data, n) == reference(data, n);
+            }
+        );
+
+        auto text = random_text(k_bench_bytes);
+        c.report("letter_set", ok, text.size(),
+            [&] { sink = aoc::simd::letter_set(text.data(), text.size()); },
+            [&] { sink = reference(text.data(), text.size()); }
+        );
+    }
+
+    void check_interval_pairs(checker& c) {
+        struct columns {
+            std::vector<int32_t> a_from, a_to, b_from, b_to;
+        };
+        // intervals over a small range, so that every kind of pair turns up, with negative ends
+        // as well to catch unsigned compares
+        auto random_columns = [](size_t n) {
+            auto add_interval = [](std::vector<int32_t>& from, std::vector<int32_t>& to) {
+                auto x = static_cast<int32_t>(rng()() % 20) - 10;
+                auto y = static_cast<int32_t>(rng()() % 20) - 10;
+                from.push_back(std::min(x, y));
+                to.push_back(std::max(x, y));
+            };
+            columns cols;
+            for (size_t i = 0; i < n; ++i) {
+                add_interval(cols.a_from, cols.a_to);
+                add_interval(cols.b_from, cols.b_to);
+            }
+            return cols;
+        };
+        auto reference = [](const columns& cols, size_t n) {
+            std::array<uint64_t, 2> counts = { 0, 0 };
+            for (size_t i = 0; i < n; ++i) {
+                auto [af, at, bf, bt] = std::tuple(
+                    cols.a_from[i], cols.a_to[i], cols.b_from[i], cols.b_to[i]
+                );
+                bool contained = (af <= bf && bt <= at) || (bf <= af && at <= bt);
+                counts[0] += contained ? 1 : 0;
+                counts[1] += (af <= bt && bf <= at) ? 1 : 0;
+            }
+            return counts;
+        };
+        auto kernel = [](const columns& cols, size_t n) {
+            return aoc::simd::count_interval_pairs(
+                cols.a_from.data(), cols.a_to.data(), cols.b_from.data(), cols.b_to.data(), n
+            );
+        };
+        bool ok = true;
+        for (size_t n = 0; n <= k_max_check_size; ++n) {
+            auto cols = random_columns(n);
+            ok = ok && kernel(cols, n) == reference(cols, n);
+        }
+
+        // the count is taken from the columns rather than the constant, and both counts are kept,
+        // so that the compiler cannot tailor the inlined reference to this one call
+        auto cols = random_columns(k_bench_bytes / (4 * sizeof(int32_t)));
+        auto n = cols.a_from.size();
+        c.report("count_interval_pairs", ok, k_bench_bytes,
+            [&] { auto counts = kernel(cols, n); sink = counts[0] + counts[1]; },
+            [&] { auto counts = reference(cols, n); sink = counts[0] + counts[1]; }
+        );
+    }
+
+    void check_prefix_sum(checker& c) {
+        auto reference = [](int32_t* data, size_t n) {
+            int32_t sum = 0;
+            for (size_t i = 0; i < n; ++i) {
+                sum += data[i];
+                data[i] = sum;
+            }
+        };
+        // small values, so that the sums cannot overflow
+        auto random_values = [](size_t n) {
+            std::vector<int32_t> values(n);
+            for (auto& v : values) {
+                v = static_cast<int32_t>(rng()() % 16) - 8;
+            }
+            return values;
+        };
+        bool ok = true;
+        for (size_t n = 0; n <= k_max_check_size; ++n) {
+            auto values = random_values(n);
+            auto expected = values;
+            aoc::simd::inclusive_prefix_sum(values.data(), n);
+            reference(expected.data(), n);
+            ok = ok && values == expected;
+        }
+
+        // zeros, as the benchmark scans the same values over and over and anything else would
+        // overflow
+        std::vector<int32_t> values(k_bench_bytes / sizeof(int32_t), 0);
+        c.report("inclusive_prefix_sum", ok, k_bench_bytes,
+            [&] { aoc::simd::inclusive_prefix_sum(values.data(), values.size()); },
+            [&] { reference(values.data(), values.size()); }
+        );
+    }
+
+    std::vector<uint64_t> random_words(size_t n) {
+        std::vector<uint64_t> words(n);
+        for (auto& w : words) {
+            w = rng()();
+        }
+        return words;
+    }
+
+    void check_popcount(checker& c) {
+        auto reference = [](const uint64_t* words, size_t n) {
+            uint64_t count = 0;
+            for (size_t i = 0; i < n; ++i) {
+                count += std::popcount(words[i]);
+            }
+            return count;
+        };
+        bool ok = true;
+        for (size_t n = 0; n <= k_max_check_size / 8; ++n) {
+            auto words = random_words(n);
+            ok = ok && aoc::simd::popcount(words.data(), n) == reference(words.data(), n);
+        }
+
+        auto words = random_words(k_bench_bytes / sizeof(uint64_t));
+        c.report("popcount", ok, k_bench_bytes,
+            [&] { sink = aoc::simd::popcount(words.data(), words.size()); },
+            [&] { sink = reference(words.data(), words.size()); }
+        );
+    }
+
+    // the bitset shifted bit by bit, for checking
+    std::vector<uint64_t> shifted(const std::vector<uint64_t>& words, size_t bits, bool left) {
+        std::vector<uint64_t> out(words.size(), 0);
+        auto total = words.size() * 64;
+        for (size_t i = 0; i < total; ++i) {
+            if (!((words[i / 64] >> (i % 64)) & 1)) {
+                continue;
+            }
+            if (left && i + bits < total) {
+                out[(i + bits) / 64] |= uint64_t{ 1 } << ((i + bits) % 64);
+            } else if (!left && i >= bits) {
+                out[(i - bits) / 64] |= uint64_t{ 1 } << ((i - bits) % 64);
+            }
+        }
+        return out;
+    }
+
+    void check_shifts(checker& c) {
+        bool left_ok = true;
+        bool right_ok = true;
+        for (size_t n = 0; n <= 12; ++n) {
+            for (size_t bits = 0; bits <= 64 * (n + 1); bits += 1 + bits / 16) {
+                auto words = random_words(n);
+                auto out = words;
+                aoc::simd::shift_left(out.data(), n, bits);
+                left_ok = left_ok && out == shifted(words, bits, true);
+                out = words;
+                aoc::simd::shift_right(out.data(), n, bits);
+                right_ok = right_ok && out == shifted(words, bits, false);
+            }
+        }
+
+        // a word-level reference for timing, as the bitwise one would flatter the kernels
+        auto reference_left = [](uint64_t* words, size_t n, size_t bits) {
+            auto word_shift = bits / 64;
+            auto bit_shift = bits % 64;
+            for (size_t i = n; i-- > 0;) {
+                uint64_t val = 0;
+                if (i >= word_shift) {
+                    val = words[i - word_shift] << bit_shift;
+                    if (bit_shift && i >= word_shift + 1) {
+                        val |= words[i - word_shift - 1] >> (64 - bit_shift);
+                    }
+                }
+                words[i] = val;
+            }
+        };
+        auto reference_right = [](uint64_t* words, size_t n, size_t bits) {
+            auto word_shift = bits / 64;
+            auto bit_shift = bits % 64;
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t val = 0;
+                if (i + word_shift < n) {
+                    val = words[i + word_shift] >> bit_shift;
+                    if (bit_shift && i + word_shift + 1 < n) {
+                        val |= words[i + word_shift + 1] << (64 - bit_shift);
+                    }
+                }
+                words[i] = val;
+            }
+        };
+        // the shift is read at run time, as a constant would let the compiler specialise the
+        // inlined reference but not the kernel behind the dispatch table
+        volatile size_t bench_bits = 3;
+        size_t bits = bench_bits;
+        auto words = random_words(k_bench_bytes / sizeof(uint64_t));
+        c.report("shift_left", left_ok, k_bench_bytes,
+            [&] { aoc::simd::shift_left(words.data(), words.size(), bits); },
+            [&] { reference_left(words.data(), words.size(), bits); }
+        );
+        c.report("shift_right", right_ok, k_bench_bytes,
+            [&] { aoc::simd::shift_right(words.data(), words.size(), bits); },
+            [&] { reference_right(words.data(), words.size(), bits); }
+        );
+    }
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+int aoc::simd_check::run(std::ostream& os) {
+    checker c(os);
+    check_count_and_find(c);
+    check_match_mask(c);
+    check_nibble_lookups(c);
+    check_record_lookups(c);
+    check_letter_set(c);
+    check_interval_pairs(c);
+    check_prefix_sum(c);
+    check_popcount(c);
+    check_shifts(c);
+    return c.failures();
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <ostream>
+
+/*------------------------------------------------------------------------------------------------*/
+
+// a check and micro-benchmark of every aoc::simd kernel, run by main's "simd" mode. each kernel
+// is run, through the dispatch table, on random inputs of many sizes and alignments and compared
+// with a plain scalar reference written here, then both are timed on a large input. only the
+// variant that the dispatch picks is exercised, so to cover them all run it once per AOC_SIMD
+// setting, which tools/simd_bench.py does.
+
+namespace aoc::simd_check {
+
+    // returns the number of kernels whose results differ from the reference
+    int run(std::ostream& os);
+}
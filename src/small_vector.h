@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+/*------------------------------------------------------------------------------------------------*/
+
+// a vector that keeps up to N elements inline and only goes to the heap beyond that, for the
+// short per-state lists built in search and simulation loops. the inline slots always hold
+// constructed objects, so T must be default constructible and cheap to assign.
+
+namespace aoc {
+
+    template <typename T, size_t N>
+    class small_vector {
+        // elements are in inline_[0, size_) while heap_ is empty, and in heap_ otherwise
+        std::array<T, N> inline_ = {};
+        std::vector<T> heap_;
+        size_t size_ = 0;
+
+        bool on_heap() const {
+            return !heap_.empty();
+        }
+
+        void spill() {
+            heap_.reserve(2 * N + 1);
+            for (size_t i = 0; i < size_; ++i) {
+                heap_.push_back(std::move(inline_[i]));
+            }
+            size_ = 0;
+        }
+
+    public:
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        small_vector() = default;
+
+        explicit small_vector(size_t n, const T& val = T{}) {
+            for (size_t i = 0; i < n; ++i) {
+                push_back(val);
+            }
+        }
+
+        small_vector(std::initializer_list<T> items) {
+            for (const auto& item : items) {
+                push_back(item);
+            }
+        }
+
+        size_t size() const {
+            return on_heap() ? heap_.size() : size_;
+        }
+
+        bool empty() const {
+            return size() == 0;
+        }
+
+        T* data() {
+            return on_heap() ? heap_.data() : inline_.data();
+        }
+
+        const T* data() const {
+            return on_heap() ? heap_.data() : inline_.data();
+        }
+
+        T* begin() { return data(); }
+        T* end() { return data() + size(); }
+        const T* begin() const { return data(); }
+        const T* end() const { return data() + size(); }
+
+        T& operator[](size_t i) { return data()[i]; }
+        const T& operator[](size_t i) const { return data()[i]; }
+
+        T& front() { return data()[0]; }
+        const T& front() const { return data()[0]; }
+        T& back() { return data()[size() - 1]; }
+        const T& back() const { return data()[size() - 1]; }
+
+        template <typename... Args>
+        T& emplace_back(Args&&... args) {
+            if (!on_heap() && size_ < N) {
+                inline_[size_] = T(std::forward<Args>(args)...);
+                return inline_[size_++];
+            }
+            if (!on_heap()) {
+                // the arguments may refer to an inline element, so build the new one first
+                T val(std::forward<Args>(args)...);
+                spill();
+                return heap_.emplace_back(std::move(val));
+            }
+            return heap_.emplace_back(std::forward<Args>(args)...);
+        }
+
+        void push_back(const T& val) {
+            emplace_back(val);
+        }
+
+        void push_back(T&& val) {
+            emplace_back(std::move(val));
+        }
+
+        void pop_back() {
+            if (on_heap()) {
+                heap_.pop_back();
+            } else {
+                --size_;
+            }
+        }
+
+        void clear() {
+            heap_.clear();
+            size_ = 0;
+        }
+
+        bool operator==(const small_vector& rhs) const {
+            if (size() != rhs.size()) {
+                return false;
+            }
+            for (size_t i = 0; i < size(); ++i) {
+                if (!((*this)[i] == rhs[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+}
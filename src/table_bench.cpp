@@ -0,0 +1,297 @@
+#include "table_bench.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    constexpr size_t k_bench_lookups = 1 << 16;
+    constexpr auto k_min_bench_time = std::chrono::milliseconds(20);
+    constexpr int k_bench_runs = 3;
+
+    // keeps the benchmarked results alive
+    volatile int64_t sink = 0;
+
+    std::mt19937_64& rng() {
+        static std::mt19937_64 gen(2022);
+        return gen;
+    }
+
+    // n keys drawn from keys
+    std::string random_keys(const std::string& keys, size_t n) {
+        std::string out(n, ' ');
+        for (auto& ch : out) {
+            ch = keys[rng()() % keys.size()];
+        }
+        return out;
+    }
+
+    // millions of lookups per second of fn, which makes the given number of them, as the best of
+    // a few runs of long enough to time
+    template <typename F>
+    double lookup_rate(size_t lookups, F fn) {
+        using clock = std::chrono::steady_clock;
+        double best = 0.0;
+        for (int run = 0; run < k_bench_runs; ++run) {
+            size_t reps = 0;
+            auto start = clock::now();
+            auto elapsed = clock::duration::zero();
+            do {
+                fn();
+                ++reps;
+                elapsed = clock::now() - start;
+            } while (elapsed < k_min_bench_time);
+            auto us = std::chrono::duration<double, std::micro>(elapsed).count();
+            best = std::max(best, static_cast<double>(lookups * reps) / us);
+        }
+        return best;
+    }
+
+    class checker {
+        std::ostream& os_;
+        int failures_ = 0;
+
+    public:
+        explicit checker(std::ostream& os) : os_(os) {
+            os_ << "  lookup tables against the maps they replaced (M lookups/s):\n";
+        }
+
+        // ok is whether the table matched the map on every key; table and map are timed over
+        // the same keys
+        template <typename T, typename M>
+        void report(const std::string& name, bool ok, T table, M map) {
+            auto table_rate = lookup_rate(k_bench_lookups, table);
+            auto map_rate = lookup_rate(k_bench_lookups, map);
+            os_ << "    " << std::left << std::setw(22) << name << std::right << std::fixed <<
+                std::setprecision(1) << std::setw(9) << table_rate << std::setw(9) <<
+                map_rate << std::setw(7) << table_rate / map_rate << "x  " <<
+                (ok ? "ok" : "MISMATCH") << "\n";
+            failures_ += ok ? 0 : 1;
+        }
+
+        int failures() const {
+            return failures_;
+        }
+    };
+
+    struct point {
+        int x;
+        int y;
+
+        bool operator==(const point&) const = default;
+    };
+
+    // true if the table and the map agree on every key
+    template <typename T, typename M>
+    bool agree_on(const std::string& keys, T table, M map) {
+        return std::all_of(keys.begin(), keys.end(), [&](char ch) { return table(ch) == map(ch); });
+    }
+
+    // day 2: a letter of either column to a shape
+
+    constexpr auto letter_to_shape_tbl = [] {
+        std::array<int, 256> tbl = {};
+        tbl['A'] = tbl['X'] = 0;
+        tbl['B'] = tbl['Y'] = 1;
+        tbl['C'] = tbl['Z'] = 2;
+        return tbl;
+    }();
+
+    int letter_to_shape_table(char letter) {
+        return letter_to_shape_tbl[static_cast<unsigned char>(letter)];
+    }
+
+    int letter_to_shape_map(char letter) {
+        const static std::unordered_map<char, int> map_letter_to_shape = {
+            {'A', 0}, {'B', 1}, {'C', 2}, {'X', 0}, {'Y', 1}, {'Z', 2}
+        };
+        return map_letter_to_shape.at(letter);
+    }
+
+    void check_letter_to_shape(checker& c) {
+        const std::string letters = "ABCXYZ";
+        bool ok = agree_on(letters, letter_to_shape_table, letter_to_shape_map);
+        auto keys = random_keys(letters, k_bench_lookups);
+        auto sum_over_keys = [&keys](auto lookup) {
+            int64_t sum = 0;
+            for (char ch : keys) {
+                sum += lookup(ch);
+            }
+            sink = sum;
+        };
+        c.report("letter to shape", ok,
+            [&] { sum_over_keys(letter_to_shape_table); },
+            [&] { sum_over_keys(letter_to_shape_map); }
+        );
+    }
+
+    // days 9 and 24: a direction letter to a step
+
+    constexpr auto dir_to_delta_tbl = [] {
+        std::array<point, 256> tbl = {};
+        tbl['U'] = { 0,1 };
+        tbl['R'] = { 1,0 };
+        tbl['D'] = { 0,-1 };
+        tbl['L'] = { -1,0 };
+        return tbl;
+    }();
+
+    point dir_to_delta_table(char dir) {
+        return dir_to_delta_tbl[static_cast<unsigned char>(dir)];
+    }
+
+    point dir_to_delta_map(char dir) {
+        const static std::unordered_map<char, point> dir_to_delta = {
+            {'U', {0,1}}, {'R', {1,0}}, {'D', {0,-1}}, {'L', {-1,0}}
+        };
+        return dir_to_delta.at(dir);
+    }
+
+    void check_dir_to_delta(checker& c) {
+        const std::string dirs = "URDL";
+        bool ok = agree_on(dirs, dir_to_delta_table, dir_to_delta_map);
+        auto keys = random_keys(dirs, k_bench_lookups);
+        // a walk, as in moving a rope's head
+        auto walk = [&keys](auto lookup) {
+            point loc = { 0,0 };
+            for (char ch : keys) {
+                auto delta = lookup(ch);
+                loc = { loc.x + delta.x, loc.y + delta.y };
+            }
+            sink = loc.x + loc.y;
+        };
+        c.report("direction to step", ok,
+            [&] { walk(dir_to_delta_table); },
+            [&] { walk(dir_to_delta_map); }
+        );
+    }
+
+    // day 21: an operator to the function that applies it, once a std::function copied out of a
+    // static map and now a plain function pointer
+
+    using binary_op = int64_t(*)(int64_t, int64_t);
+
+    constexpr auto op_tbl = [] {
+        std::array<binary_op, 256> tbl = {};
+        tbl['+'] = [](int64_t lhs, int64_t rhs)->int64_t { return lhs + rhs; };
+        tbl['-'] = [](int64_t lhs, int64_t rhs)->int64_t { return lhs - rhs; };
+        tbl['*'] = [](int64_t lhs, int64_t rhs)->int64_t { return lhs * rhs; };
+        tbl['/'] = [](int64_t lhs, int64_t rhs)->int64_t { return lhs / rhs; };
+        return tbl;
+    }();
+
+    int64_t apply_op_table(char op, int64_t lhs, int64_t rhs) {
+        return op_tbl[static_cast<unsigned char>(op)](lhs, rhs);
+    }
+
+    int64_t apply_op_map(char op, int64_t lhs, int64_t rhs) {
+        const static std::unordered_map<char, std::function<int64_t(int64_t, int64_t)>> op_map = {
+            {'+', [](int64_t lhs, int64_t rhs)->int64_t { return lhs + rhs; }},
+            {'-', [](int64_t lhs, int64_t rhs)->int64_t { return lhs - rhs; }},
+            {'*', [](int64_t lhs, int64_t rhs)->int64_t { return lhs * rhs; }},
+            {'/', [](int64_t lhs, int64_t rhs)->int64_t { return lhs / rhs; }}
+        };
+        auto func = op_map.at(op);
+        return func(lhs, rhs);
+    }
+
+    void check_operators(checker& c) {
+        const std::string ops = "+-*/";
+        bool ok = agree_on(ops,
+            [](char op) { return apply_op_table(op, 84, 12); },
+            [](char op) { return apply_op_map(op, 84, 12); }
+        );
+        auto keys = random_keys(ops, k_bench_lookups);
+        // the operands stay small and nonzero, as the point is the lookup and the call
+        auto fold = [&keys](auto apply) {
+            int64_t acc = 0;
+            for (char op : keys) {
+                acc += apply(op, (acc & 0xff) + 7, 3);
+            }
+            sink = acc;
+        };
+        c.report("operator to function", ok,
+            [&] { fold(apply_op_table); },
+            [&] { fold(apply_op_map); }
+        );
+    }
+
+    // day 21: the operation that undoes an operator, by which side the unknown is on. it was a
+    // map keyed by strings that solve_for_x rebuilt on every call
+
+    struct inverse_op {
+        char op;
+        bool arg_first;
+
+        bool operator==(const inverse_op&) const = default;
+    };
+
+    constexpr auto inverse_op_tbl = [] {
+        std::array<std::array<inverse_op, 2>, 256> tbl = {};
+        tbl['+'] = { { {'-', false}, {'-', false} } };
+        tbl['-'] = { { {'-', true},  {'+', false} } };
+        tbl['*'] = { { {'/', false}, {'/', false} } };
+        tbl['/'] = { { {'/', true},  {'*', false} } };
+        return tbl;
+    }();
+
+    inverse_op inverse_table(char op, bool unknown_on_left) {
+        return inverse_op_tbl[static_cast<unsigned char>(op)][unknown_on_left];
+    }
+
+    inverse_op inverse_map(char op, bool unknown_on_left) {
+        std::string key = std::string(1, op) + ((unknown_on_left) ? "L" : "R");
+        std::unordered_map<std::string, inverse_op> inverse = {
+            {"-L", {'+', false}}, {"+L", {'-', false}},
+            {"-R", {'-', true}},  {"+R", {'-', false}},
+            {"/L", {'*', false}}, {"*L", {'/', false}},
+            {"/R", {'/', true}},  {"*R", {'/', false}}
+        };
+        return inverse.at(key);
+    }
+
+    void check_inverse_operators(checker& c) {
+        const std::string ops = "+-*/";
+        bool ok = agree_on(ops,
+            [](char op) { return inverse_table(op, true); },
+            [](char op) { return inverse_map(op, true); }
+        ) && agree_on(ops,
+            [](char op) { return inverse_table(op, false); },
+            [](char op) { return inverse_map(op, false); }
+        );
+        auto keys = random_keys(ops, k_bench_lookups);
+        auto count_over_keys = [&keys](auto inverse) {
+            int64_t count = 0;
+            bool left = false;
+            for (char op : keys) {
+                auto inv = inverse(op, left);
+                count += inv.op + inv.arg_first;
+                left = !left;
+            }
+            sink = count;
+        };
+        c.report("inverse operator", ok,
+            [&] { count_over_keys(inverse_table); },
+            [&] { count_over_keys(inverse_map); }
+        );
+    }
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+int aoc::table_bench::run(std::ostream& os) {
+    checker c(os);
+    check_letter_to_shape(c);
+    check_dir_to_delta(c);
+    check_operators(c);
+    check_inverse_operators(c);
+    return c.failures();
+}
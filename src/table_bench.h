@@ -0,0 +1,17 @@
+#pragma once
+
+#include <ostream>
+
+/*------------------------------------------------------------------------------------------------*/
+
+// a check and micro-benchmark of the constexpr lookup tables that replaced small static hash
+// maps in the days, run by main's "tables" mode. each kind of lookup is written both ways here,
+// the map just as the days used to have it, as a function-local static or one rebuilt on every
+// call, and the two are checked against each other on every key and then timed over a long run
+// of random keys.
+
+namespace aoc::table_bench {
+
+    // returns the number of tables whose entries differ from the map's
+    int run(std::ostream& os);
+}
@@ -4,6 +4,24 @@
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <exception>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace r = ranges;
 namespace rv = ranges::views;
@@ -23,6 +41,122 @@ namespace {
             return !std::isspace(ch);
             }).base(), s.end());
     }
+
+    // a single process-wide pool. the thread that posts a job also works on it, so a task
+    // that itself calls parallel_for cannot deadlock waiting for busy workers.
+    class task_pool {
+        struct job {
+            const std::function<void(int64_t)>* task;
+            int64_t num_tasks;
+            std::atomic<int64_t> next;
+            std::atomic<int64_t> finished;
+            std::exception_ptr error;
+
+            job(const std::function<void(int64_t)>* t, int64_t n) :
+                task(t), num_tasks(n), next(0), finished(0)
+            {}
+        };
+        using job_ptr = std::shared_ptr<job>;
+
+        std::mutex mutex_;
+        std::condition_variable work_available_;
+        std::condition_variable job_finished_;
+        std::deque<job_ptr> jobs_;
+        std::vector<std::thread> workers_;
+        bool stopping_;
+
+        bool work_on(job& j) {
+            auto i = j.next++;
+            if (i >= j.num_tasks) {
+                return false;
+            }
+            try {
+                (*j.task)(i);
+            } catch (...) {
+                std::lock_guard lock(mutex_);
+                if (!j.error) {
+                    j.error = std::current_exception();
+                }
+            }
+            if (++j.finished == j.num_tasks) {
+                std::lock_guard lock(mutex_);
+                job_finished_.notify_all();
+            }
+            return true;
+        }
+
+        void worker_loop() {
+            while (true) {
+                job_ptr j;
+                {
+                    std::unique_lock lock(mutex_);
+                    work_available_.wait(lock, [this] {return stopping_ || !jobs_.empty(); });
+                    if (stopping_) {
+                        return;
+                    }
+                    j = jobs_.front();
+                    if (j->next >= j->num_tasks) {
+                        jobs_.pop_front();
+                        continue;
+                    }
+                }
+                while (work_on(*j))
+                    ;
+            }
+        }
+
+    public:
+        task_pool() : stopping_(false) {
+            auto n = std::thread::hardware_concurrency();
+            for (unsigned i = 1; i < n; ++i) {
+                workers_.emplace_back([this] { worker_loop(); });
+            }
+        }
+
+        ~task_pool() {
+            {
+                std::lock_guard lock(mutex_);
+                stopping_ = true;
+            }
+            work_available_.notify_all();
+            for (auto& worker : workers_) {
+                worker.join();
+            }
+        }
+
+        void run(int64_t num_tasks, const std::function<void(int64_t)>& task) {
+            auto j = std::make_shared<job>(&task, num_tasks);
+            if (num_tasks > 1 && !workers_.empty()) {
+                {
+                    std::lock_guard lock(mutex_);
+                    jobs_.push_back(j);
+                }
+                work_available_.notify_all();
+            }
+            while (work_on(*j))
+                ;
+            {
+                std::unique_lock lock(mutex_);
+                auto iter = std::find(jobs_.begin(), jobs_.end(), j);
+                if (iter != jobs_.end()) {
+                    jobs_.erase(iter);
+                }
+                job_finished_.wait(lock, [&j] {return j->finished == j->num_tasks; });
+            }
+            if (j->error) {
+                std::rethrow_exception(j->error);
+            }
+        }
+    };
+
+    task_pool& shared_task_pool() {
+        static task_pool pool;
+        return pool;
+    }
+}
+
+void aoc::detail::run_parallel_tasks(int64_t num_tasks, const std::function<void(int64_t)>& task) {
+    shared_task_pool().run(num_tasks, task);
 }
 
 std::vector<std::string> aoc::file_to_string_vector(const std::string& filename) {
@@ -82,6 +216,93 @@ std::string aoc::file_to_string(const std::string& filename) {
     return buffer.str();
 }
 
+struct aoc::mapped_file::impl {
+    const char* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+
+    ~impl() {
+        if (data) {
+            UnmapViewOfFile(data);
+        }
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+        if (file != INVALID_HANDLE_VALUE) {
+            CloseHandle(file);
+        }
+    }
+#else
+    ~impl() {
+        if (data && size) {
+            munmap(const_cast<char*>(data), size);
+        }
+    }
+#endif
+};
+
+aoc::mapped_file::mapped_file(const std::string& path) :
+        impl_(std::make_unique<impl>()) {
+#ifdef _WIN32
+    impl_->file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (impl_->file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("unable to open " + path);
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(impl_->file, &size)) {
+        throw std::runtime_error("unable to map " + path);
+    }
+    if (size.QuadPart == 0) {
+        return;
+    }
+    impl_->mapping = CreateFileMappingA(impl_->file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!impl_->mapping) {
+        throw std::runtime_error("unable to map " + path);
+    }
+    impl_->data = static_cast<const char*>(MapViewOfFile(impl_->mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!impl_->data) {
+        throw std::runtime_error("unable to map " + path);
+    }
+    impl_->size = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("unable to open " + path);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throw std::runtime_error("unable to map " + path);
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        return;
+    }
+    void* ptr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED) {
+        throw std::runtime_error("unable to map " + path);
+    }
+    impl_->data = static_cast<const char*>(ptr);
+    impl_->size = static_cast<size_t>(st.st_size);
+#endif
+}
+
+aoc::mapped_file::mapped_file(mapped_file&&) noexcept = default;
+aoc::mapped_file& aoc::mapped_file::operator=(mapped_file&&) noexcept = default;
+aoc::mapped_file::~mapped_file() = default;
+
+const char* aoc::mapped_file::data() const {
+    return impl_->data;
+}
+
+size_t aoc::mapped_file::size() const {
+    return impl_->size;
+}
+
 std::vector<std::vector<int>> aoc::strings_to_2D_array_of_digits(const std::vector<std::string>& lines) {
     std::vector<std::vector<int>> grid(lines.size());
     std::transform(lines.begin(), lines.end(), grid.begin(),
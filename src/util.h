@@ -3,6 +3,13 @@
 #include <vector>
 #include <string>
 #include <stdexcept>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <memory>
 
 namespace aoc {
     std::vector<std::string> file_to_string_vector(const std::string& filename);
@@ -17,6 +24,21 @@ namespace aoc {
     std::string remove_nonnumeric(const std::string& str);
     std::string trim(const std::string& str);
 
+    // a read-only memory mapping of a whole file, for days that parse their input in place. an
+    // empty file is an empty view rather than an error.
+    class mapped_file {
+        struct impl;
+        std::unique_ptr<impl> impl_;
+    public:
+        explicit mapped_file(const std::string& path);
+        mapped_file(mapped_file&&) noexcept;
+        mapped_file& operator=(mapped_file&&) noexcept;
+        ~mapped_file();
+
+        const char* data() const;
+        size_t size() const;
+    };
+
     template <std::size_t... Is>
     auto create_tuple_impl(std::index_sequence<Is...>, const std::vector<std::string>& arguments) {
         return std::make_tuple(arguments[Is]...);
@@ -32,4 +54,94 @@ namespace aoc {
         auto vec = split(s, delim);
         return create_tuple<N>(vec);
     }
+
+    namespace detail {
+        void run_parallel_tasks(int64_t num_tasks, const std::function<void(int64_t)>& task);
+
+        // the number of chunks depends only on the size of the range, never on the number of
+        // threads, so that reductions combine partial results the same way on every machine.
+        constexpr int64_t k_max_parallel_chunks = 256;
+
+        inline int64_t num_parallel_chunks(int64_t n) {
+            return (n < k_max_parallel_chunks) ? n : k_max_parallel_chunks;
+        }
+
+        inline std::pair<int64_t, int64_t> chunk_bounds(int64_t from, int64_t to, int64_t chunks, int64_t chunk) {
+            auto n = to - from;
+            return {
+                from + (n * chunk) / chunks,
+                from + (n * (chunk + 1)) / chunks
+            };
+        }
+    }
+
+    template <typename F>
+    void parallel_for(int64_t from, int64_t to, F body) {
+        if (to <= from) {
+            return;
+        }
+        auto chunks = detail::num_parallel_chunks(to - from);
+        detail::run_parallel_tasks(chunks,
+            [&](int64_t chunk) {
+                auto [lo, hi] = detail::chunk_bounds(from, to, chunks, chunk);
+                for (auto i = lo; i < hi; ++i) {
+                    body(i);
+                }
+            }
+        );
+    }
+
+    // partial results are folded left to right in chunk order after all chunks complete, so
+    // the answer does not depend on which thread finished first.
+    template <typename T, typename Reduce, typename Transform>
+    T parallel_transform_reduce(int64_t from, int64_t to, T init, Reduce reduce, Transform transform) {
+        if (to <= from) {
+            return init;
+        }
+        auto chunks = detail::num_parallel_chunks(to - from);
+        std::vector<std::optional<T>> partials(chunks);
+        detail::run_parallel_tasks(chunks,
+            [&](int64_t chunk) {
+                auto [lo, hi] = detail::chunk_bounds(from, to, chunks, chunk);
+                T acc = transform(lo);
+                for (auto i = lo + 1; i < hi; ++i) {
+                    acc = reduce(std::move(acc), transform(i));
+                }
+                partials[chunk] = std::move(acc);
+            }
+        );
+        for (auto& partial : partials) {
+            init = reduce(std::move(init), std::move(*partial));
+        }
+        return init;
+    }
+
+    // runs each callable as a task of its own on the shared pool and returns their results, in
+    // argument order, once all of them are done. days use it to run part 1 and part 2 side by
+    // side over the same read-only parsed input.
+    template <typename... Fs>
+    auto parallel_invoke(Fs&&... fns) {
+        std::tuple<std::optional<std::invoke_result_t<Fs&>>...> results;
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            detail::run_parallel_tasks(static_cast<int64_t>(sizeof...(Fs)),
+                [&](int64_t i) {
+                    ((i == static_cast<int64_t>(Is) ? (void)std::get<Is>(results).emplace(fns()) : void()), ...);
+                }
+            );
+        }(std::index_sequence_for<Fs...>{});
+        return std::apply(
+            [](auto&... result) {
+                return std::tuple{ std::move(*result)... };
+            },
+            results
+        );
+    }
+
+    template <typename T, typename Container, typename Reduce>
+    T parallel_reduce(const Container& items, T init, Reduce reduce) {
+        return parallel_transform_reduce(
+            0, static_cast<int64_t>(items.size()), std::move(init), reduce,
+            [&items](int64_t i) { return items[i]; }
+        );
+    }
 }
\ No newline at end of file
@@ -0,0 +1,40 @@
+#!/usr/bin/env python3
+"""Writes src/embedded_input.h, which holds input/day_N_1.txt for the startup-critical days as
+constexpr byte arrays. Run it before building with AOC_EMBED_INPUT defined:
+
+    python tools/embed_inputs.py [day ...]
+
+The embedded days are evaluated by the compiler; MSVC may need /constexpr:steps raised.
+"""
+import pathlib
+import sys
+
+DEFAULT_DAYS = [2, 4, 10, 17, 25]
+ROOT = pathlib.Path(__file__).resolve().parent.parent
+
+
+def embed(day):
+    data = (ROOT / "input" / f"day_{day}_1.txt").read_bytes().replace(b"\r\n", b"\n")
+    rows = [", ".join(str(b) for b in data[i:i + 24]) for i in range(0, len(data), 24)]
+    body = ",\n        ".join(rows) if rows else "0"
+    return (
+        f"    inline constexpr char day_{day}_data[] = {{\n        {body}\n    }};\n"
+        f"    inline constexpr std::string_view day_{day}(day_{day}_data, {len(data)});\n"
+    )
+
+
+def main():
+    days = [int(arg) for arg in sys.argv[1:]] or DEFAULT_DAYS
+    out = [
+        "#pragma once\n",
+        "// generated by tools/embed_inputs.py -- do not edit\n",
+        "#include <string_view>\n",
+        "namespace aoc::embedded {\n",
+    ]
+    out += [embed(day) for day in days]
+    out.append("}\n")
+    (ROOT / "src" / "embedded_input.h").write_text("\n".join(out))
+
+
+if __name__ == "__main__":
+    main()
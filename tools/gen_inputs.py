@@ -0,0 +1,232 @@
+#!/usr/bin/env python3
+"""Writes synthetic puzzle inputs, as day_N_1.txt files, for performance testing.
+
+    python tools/gen_inputs.py OUT_DIR [--mode random|adversarial] [--scale N] [--seed N] [day ...]
+
+"random" gives inputs shaped like the real ones. "adversarial" aims at known weak spots:
+
+    7   one long chain of nested directories (recursion depth, repeated cd)
+    9   a few moves with very long runs in a single direction
+    14  a tall, narrow shaft that every grain has to fall down
+    16  a complete valve graph (every valve tunnels to every other)
+    21  a single dependency chain from root down to humn
+
+Run the days against the output with AOC_INPUT_DIR=OUT_DIR, or use tools/stress.py.
+"""
+import argparse
+import pathlib
+import random
+
+
+def name_of(i, width=4):
+    """a lowercase name for i, distinct for distinct i"""
+    letters = []
+    for _ in range(width):
+        letters.append(chr(ord("a") + i % 26))
+        i //= 26
+    return "".join(letters) + (str(i) if i else "")
+
+
+def valve_label(i):
+    return chr(ord("A") + i // 26) + chr(ord("A") + i % 26)
+
+
+# ---- day 7
+
+def day_7_random(rng, scale):
+    lines = ["$ cd /"]
+    depth = 0
+    for i in range(200 * scale):
+        lines.append("$ ls")
+        lines.append(f"dir {name_of(i)}")
+        for j in range(rng.randint(1, 4)):
+            lines.append(f"{rng.randint(1000, 300000)} f{j}.txt")
+        if depth > 0 and rng.random() < 0.4:
+            lines.append("$ cd ..")
+            depth -= 1
+        else:
+            lines.append(f"$ cd {name_of(i)}")
+            depth += 1
+    return lines
+
+
+def day_7_adversarial(rng, scale):
+    lines = ["$ cd /"]
+    for i in range(20000 * scale):
+        lines += ["$ ls", "dir d", f"{rng.randint(1, 1000)} f.txt", "$ cd d"]
+    return lines
+
+
+# ---- day 9
+
+def day_9_random(rng, scale):
+    return [f"{rng.choice('UDLR')} {rng.randint(1, 20)}" for _ in range(2000 * scale)]
+
+
+def day_9_adversarial(rng, scale):
+    run = 100000 * scale
+    return [f"{dir} {run}" for dir in "RULDRDLU"]
+
+
+# ---- day 14
+
+def polyline(points):
+    return " -> ".join(f"{x},{y}" for x, y in points)
+
+
+def day_14_random(rng, scale):
+    lines = []
+    for _ in range(100 * scale):
+        x, y = rng.randint(460, 540), rng.randint(10, 170)
+        points = [(x, y)]
+        for _ in range(rng.randint(1, 4)):
+            if rng.random() < 0.5:
+                x = max(1, x + rng.randint(-8, 8))
+            else:
+                y = max(1, y + rng.randint(-8, 8))
+            points.append((x, y))
+        lines.append(polyline(points))
+    return lines
+
+
+def day_14_adversarial(rng, scale):
+    depth = 2000 * scale
+    return [polyline([(499, 2), (499, depth), (501, depth), (501, 2)])]
+
+
+# ---- day 16
+
+def valve_line(label, flow, tunnels):
+    if len(tunnels) == 1:
+        return f"Valve {label} has flow rate={flow}; tunnel leads to valve {tunnels[0]}"
+    return f"Valve {label} has flow rate={flow}; tunnels lead to valves {', '.join(tunnels)}"
+
+
+def day_16_random(rng, scale):
+    n = min(50 * scale, 26 * 26)
+    labels = ["AA"] + [valve_label(i) for i in range(1, n)]
+    # a random spanning tree plus a few extra tunnels, with about fifteen working valves
+    edges = {label: set() for label in labels}
+    for i in range(1, n):
+        j = rng.randrange(i)
+        edges[labels[i]].add(labels[j])
+        edges[labels[j]].add(labels[i])
+    for _ in range(n // 4):
+        u, v = rng.sample(labels, 2)
+        edges[u].add(v)
+        edges[v].add(u)
+    working = set(rng.sample(labels[1:], min(15, n - 1)))
+    return [
+        valve_line(label, rng.randint(3, 25) if label in working else 0, sorted(edges[label]))
+        for label in labels
+    ]
+
+
+def day_16_adversarial(rng, scale):
+    n = min(16 + 4 * scale, 26 * 26)
+    labels = ["AA"] + [valve_label(i) for i in range(1, n)]
+    working = set(rng.sample(labels[1:], min(15, n - 1)))
+    return [
+        valve_line(
+            label,
+            rng.randint(3, 25) if label in working else 0,
+            [other for other in labels if other != label]
+        )
+        for label in labels
+    ]
+
+
+# ---- day 21
+
+def day_21_chain(rng, length, shuffle):
+    # build the chain upward from humn, tracking its value so that every inverse is exact
+    humn = rng.randint(1, 1000)
+    answer = rng.randint(1, 1000)
+    value, target = humn, answer
+    lines = [f"humn: {humn}"]
+    below = "humn"
+    consts = 0
+
+    def const(v):
+        nonlocal consts
+        consts += 1
+        name = "k" + name_of(consts)
+        lines.append(f"{name}: {v}")
+        return name
+
+    for i in range(length):
+        var = "v" + name_of(i)
+        # like the real inputs, every literal is positive and fits in an int
+        c = rng.randint(2, 9)
+        choices = ["+"]
+        if max(value, target) < 10**9:
+            choices.append("r-")
+        if min(value, target) > c:
+            choices.append("-")
+        if max(value, target) < 10**8:
+            choices.append("*")
+        if value % c == 0 and target % c == 0:
+            choices.append("/")
+        op = rng.choice(choices)
+        if op == "r-":
+            c += max(value, target)
+        if op == "+":
+            lines.append(f"{var}: {below} + {const(c)}")
+            value, target = value + c, target + c
+        elif op == "-":
+            lines.append(f"{var}: {below} - {const(c)}")
+            value, target = value - c, target - c
+        elif op == "r-":
+            lines.append(f"{var}: {const(c)} - {below}")
+            value, target = c - value, c - target
+        elif op == "*":
+            lines.append(f"{var}: {const(c)} * {below}")
+            value, target = value * c, target * c
+        else:
+            lines.append(f"{var}: {below} / {const(c)}")
+            value, target = value // c, target // c
+        below = var
+    lines.append(f"root: {below} + {const(target)}")
+    if shuffle:
+        rng.shuffle(lines)
+    return lines
+
+
+def day_21_random(rng, scale):
+    return day_21_chain(rng, 60 * scale, True)
+
+
+def day_21_adversarial(rng, scale):
+    return day_21_chain(rng, 20000 * scale, True)
+
+
+GENERATORS = {
+    7: (day_7_random, day_7_adversarial),
+    9: (day_9_random, day_9_adversarial),
+    14: (day_14_random, day_14_adversarial),
+    16: (day_16_random, day_16_adversarial),
+    21: (day_21_random, day_21_adversarial),
+}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("out_dir")
+    parser.add_argument("days", nargs="*", type=int)
+    parser.add_argument("--mode", choices=["random", "adversarial"], default="adversarial")
+    parser.add_argument("--scale", type=int, default=1)
+    parser.add_argument("--seed", type=int, default=2022)
+    args = parser.parse_args()
+
+    out_dir = pathlib.Path(args.out_dir)
+    out_dir.mkdir(parents=True, exist_ok=True)
+    for day in args.days or sorted(GENERATORS):
+        rng = random.Random(args.seed * 100 + day)
+        generate = GENERATORS[day][args.mode == "adversarial"]
+        lines = generate(rng, args.scale)
+        (out_dir / f"day_{day}_1.txt").write_text("\n".join(lines) + "\n")
+        print(f"day {day}: {len(lines)} lines")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,34 @@
+#!/usr/bin/env python3
+"""Checks and times the simd kernels once per instruction set, by running the solver's "simd"
+mode with AOC_SIMD capping the dispatch at scalar, at sse4.2 and not at all.
+
+    python tools/simd_bench.py PATH_TO_EXE
+"""
+import argparse
+import os
+import subprocess
+import sys
+
+# the AOC_SIMD values to run under; None leaves the widest supported variant selected
+CAPS = ["scalar", "sse4.2", None]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("exe")
+    args = parser.parse_args()
+
+    failures = 0
+    for cap in CAPS:
+        env = dict(os.environ)
+        env.pop("AOC_SIMD", None)
+        if cap:
+            env["AOC_SIMD"] = cap
+        result = subprocess.run([args.exe, "simd"], env=env, capture_output=True, text=True)
+        sys.stdout.write(result.stdout)
+        failures += result.returncode != 0
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
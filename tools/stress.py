@@ -0,0 +1,60 @@
+#!/usr/bin/env python3
+"""Generates inputs with tools/gen_inputs.py and times the solver on each of them, flagging
+crashes (a stack overflow shows up as a signal or a non-zero exit) and runs over the limit.
+
+    python tools/stress.py PATH_TO_EXE [--mode random|adversarial] [--scale N] [--seed N]
+                           [--timeout SECS] [day ...]
+"""
+import argparse
+import os
+import pathlib
+import subprocess
+import sys
+import tempfile
+import time
+
+ROOT = pathlib.Path(__file__).resolve().parent.parent
+sys.path.insert(0, str(ROOT / "tools"))
+
+import gen_inputs  # noqa: E402
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("exe")
+    parser.add_argument("days", nargs="*", type=int)
+    parser.add_argument("--mode", choices=["random", "adversarial"], default="adversarial")
+    parser.add_argument("--scale", type=int, default=1)
+    parser.add_argument("--seed", type=int, default=2022)
+    parser.add_argument("--timeout", type=float, default=60.0)
+    args = parser.parse_args()
+
+    days = args.days or sorted(gen_inputs.GENERATORS)
+    failures = 0
+    with tempfile.TemporaryDirectory() as out_dir:
+        subprocess.run(
+            [sys.executable, str(ROOT / "tools" / "gen_inputs.py"), out_dir,
+             "--mode", args.mode, "--scale", str(args.scale), "--seed", str(args.seed)] +
+            [str(day) for day in days],
+            check=True, stdout=subprocess.DEVNULL
+        )
+        env = dict(os.environ, AOC_INPUT_DIR=out_dir)
+        for day in days:
+            start = time.perf_counter()
+            try:
+                result = subprocess.run(
+                    [args.exe, str(day)], env=env, capture_output=True, text=True,
+                    timeout=args.timeout
+                )
+                elapsed = time.perf_counter() - start
+                status = "ok" if result.returncode == 0 else f"FAILED ({result.returncode})"
+            except subprocess.TimeoutExpired:
+                elapsed = args.timeout
+                status = "TIMEOUT"
+            failures += status != "ok"
+            print(f"day {day:2}: {elapsed:8.3f}s  {status}")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())